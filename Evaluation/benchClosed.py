@@ -0,0 +1,41 @@
+import fim
+import json
+import sys
+import time
+
+if len(sys.argv) < 2:
+	print("Usage: {} <CONFIG> [<CONFIG> ...]".format(sys.argv[0]))
+	sys.exit()
+
+threads=0 # Use max. number of possible threads
+verbose=3
+algos={'t': 'Prefix Trees', 'h': 'Hash Index', 'f': 'Flat Trees'}
+
+print("{:<24} {:>4} {:>12} {:>14} {:>14} {:>14}".format("Config", "Job", "Closed", algos['t'], algos['h'], algos['f']))
+
+for cfgFile in sys.argv[1:]:
+	with open(cfgFile, 'r') as file:
+		cfg = json.load(file)
+
+	transactions = []
+
+	# Read the transaction database
+	for line in open("datasets/{}".format(cfg['filename'])):
+		transactions.append([int(i) for i in line.split()])
+
+	for idx, job in enumerate(cfg['jobs']):
+		times = {}
+		counts = {}
+
+		# Run growth and closed detection sequentially, so only the closed detection differs
+		for algo in algos:
+			start = time.time()
+			res = fim.fpgrowth(tracts=transactions, target='c', supp=job['min_supp'], zmin=job['min_occ'], zmax=0, report='a', algo='s', min_neu=job['min_neu'], verbose=verbose, winlen=cfg['winlen'], threads=threads, pipelined=False, cdalgo=algo)
+			times[algo] = time.time() - start
+			counts[algo] = len(res)
+
+		for algo in algos:
+			if counts[algo] != counts['t']:
+				print("Mismatch in job {}: {} ({}) vs. {} ({}) closed itemsets".format(idx, counts['t'], algos['t'], counts[algo], algos[algo]))
+
+		print("{:<24} {:>4} {:>12} {:>13.3f}s {:>13.3f}s {:>13.3f}s".format(cfg['filename'], idx, counts['t'], times['t'], times['h'], times['f']))
@@ -20,6 +20,7 @@ for line in open("datasets/{}".format(cfg['filename'])):
 	transactions.append([int(i) for i in line.split()])
 
 
-for job in cfg['jobs']:
-	# The result 'res' is a numpy array
-	res = fim.fpgrowth(tracts=transactions, target='c', supp=job['min_supp'], zmin=job['min_occ'], zmax=0, report='a', algo='s', min_neu=job['min_neu'], verbose=verbose, winlen=cfg['winlen'], threads=threads)
+jobs = [{'supp': job['min_supp'], 'zmin': job['min_occ'], 'zmax': 0, 'min_neu': job['min_neu']} for job in cfg['jobs']]
+
+# All jobs share the preprocessing, the tree and a single growth, 'res' holds one result list per job
+res = fim.fpgrowth_jobs(tracts=transactions, jobs=jobs, target='c', verbose=verbose, winlen=cfg['winlen'], threads=threads)
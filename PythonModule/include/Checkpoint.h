@@ -0,0 +1,236 @@
+/*
+ *  File: Checkpoint.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+/*
+ * Checkpoint of a running growth. The top-level items are mined independently
+ * and every item fills its own bucket, hence, the completed buckets are appended
+ * to the checkpoint while the growth is running. A resumed run restores the tree
+ * and these buckets and only mines the remaining items. A checkpoint belongs to
+ * a run given by a key (fingerprint of the transactions and the parameters).
+ *
+ * File data: magic, key, encoded tree (see FPGrowth::WriteTree), per completed
+ * bucket: index, word count, records (length, support, items) (all 64-bit).
+ * A truncated last bucket (e.g., of a killed run) is dropped on resume.
+ */
+
+#pragma once
+
+#include "FPGrowth.h"
+#include "Logger.h"
+#include "Pattern.h"
+#include "ResultCache.h"
+#include "Timer.h"
+#include "Types.h"
+#include "Utils.h"
+
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Checkpoint
+{
+	DISABLE_COPY_ASSIGN_MOVE(Checkpoint)
+
+	static constexpr uint64_t MAGIC = 0x314b504746; // "FPGK1"
+
+public:
+	// The buckets are flushed to the file at most every interval seconds
+	Checkpoint(const std::string& path, const uint64_t& key, const double& interval) :
+		m_path(path),
+		m_key(key),
+		m_interval(interval),
+		m_file(),
+		m_mtx(),
+		m_flushTimer(),
+		m_written(0),
+		m_failed(false)
+	{}
+
+	// Key of a run: fingerprint of the transactions (before the reduction) and of the parameters that affect the buckets
+	static uint64_t Key(const Transactions& transactions, std::initializer_list<uint64_t> params)
+	{
+		uint64_t hash = ResultCache::Fingerprint(transactions);
+
+		for (const uint64_t& val : params)
+		{
+			for (std::size_t i = 0; i < sizeof(uint64_t); i++)
+			{
+				hash ^= (val >> (i * 8)) & 0xFF;
+				hash *= 0x100000001b3;
+			}
+		}
+
+		return hash;
+	}
+
+	// Checks if there is a checkpoint of this run
+	bool CanResume() const
+	{
+		std::ifstream file(m_path, std::ios::binary);
+		uint64_t magic = 0;
+		uint64_t key   = 0;
+
+		if (!file.is_open()) return false;
+
+		if (!read(file, magic) || magic != MAGIC || !read(file, key) || key != m_key)
+		{
+			LOG_WARNING << "Checkpoint " << m_path << " belongs to a different run, it is replaced" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	// Restores the tree and the completed buckets into fp (built from an empty database), returns false if the tree
+	// cannot be read. The file is truncated behind the last complete bucket, further buckets are appended by Open.
+	bool Load(FPGrowth& fp)
+	{
+		std::ifstream file(m_path, std::ios::binary);
+		uint64_t magic = 0;
+		uint64_t key   = 0;
+
+		if (!read(file, magic) || !read(file, key) || !fp.ReadTree(file))
+		{
+			LOG_WARNING << "Invalid checkpoint: " << m_path << std::endl;
+			return false;
+		}
+
+		std::vector<PatternType> data;
+		std::streamoff end = file.tellg();
+		std::size_t buckets = 0;
+		std::size_t sets    = 0;
+
+		while (true)
+		{
+			uint64_t idx   = 0;
+			uint64_t words = 0;
+			if (!read(file, idx) || !read(file, words)) break;
+
+			data.resize(words);
+			if (words > 0 && !file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(words * sizeof(PatternType)))) break;
+			if (!fp.RestoreBucket(idx, data.data(), data.size())) break;
+
+			end = file.tellg();
+			buckets++;
+			for (std::size_t off = 0; off < data.size(); off += data[off] + Pattern::OFFSET)
+				sets++;
+		}
+
+		file.close();
+
+		std::error_code ec;
+		std::filesystem::resize_file(m_path, static_cast<uintmax_t>(end), ec);
+
+		LOG_INFO << "Resuming from checkpoint " << m_path << ": " << buckets << " / " << fp.GetItemCount() << " items completed (" << sets << " sets)" << std::endl;
+		return true;
+	}
+
+	// Starts appending the completed buckets, a new checkpoint starts with the tree of fp
+	void Open(const FPGrowth& fp, const bool& resumed)
+	{
+		if (!resumed)
+		{
+			std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+			write(file, MAGIC);
+			write(file, m_key);
+			fp.WriteTree(file);
+
+			if (!file)
+			{
+				LOG_WARNING << "Unable to write the checkpoint: " << m_path << std::endl;
+				m_failed = true;
+				return;
+			}
+		}
+
+		m_file.open(m_path, std::ios::binary | std::ios::app);
+		m_failed = !m_file.is_open();
+		m_flushTimer.Start();
+	}
+
+	// Appends a completed bucket (called by the growth threads), errors disable the checkpoint with a warning
+	void Write(const std::size_t& idx, const Pattern& bucket)
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		if (m_failed) return;
+
+		uint64_t words = 0;
+		for (const PatternType* pRec : bucket)
+			words += pRec[Pattern::LEN_IDX] + Pattern::OFFSET;
+
+		write(m_file, idx);
+		write(m_file, words);
+		for (const PatternType* pRec : bucket)
+			m_file.write(reinterpret_cast<const char*>(pRec), static_cast<std::streamsize>((pRec[Pattern::LEN_IDX] + Pattern::OFFSET) * sizeof(PatternType)));
+
+		m_written++;
+
+		if (m_flushTimer.GetElapsedTimeInSec() >= m_interval)
+		{
+			m_file.flush();
+			m_flushTimer.Start();
+		}
+
+		if (!m_file)
+		{
+			LOG_WARNING << "Unable to write the checkpoint: " << m_path << ", checkpointing disabled" << std::endl;
+			m_failed = true;
+		}
+	}
+
+	// Removes the checkpoint once the run is complete
+	void Remove()
+	{
+		if (m_file.is_open()) m_file.close();
+
+		std::error_code ec;
+		std::filesystem::remove(m_path, ec);
+	}
+
+private:
+	static bool read(std::ifstream& file, uint64_t& val)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&val), sizeof(uint64_t)));
+	}
+
+	static void write(std::ofstream& file, const uint64_t& val)
+	{
+		file.write(reinterpret_cast<const char*>(&val), sizeof(uint64_t));
+	}
+
+private:
+	std::string m_path;
+	uint64_t m_key;
+	double m_interval;
+	std::ofstream m_file;
+	std::mutex m_mtx;
+	Timer m_flushTimer;
+	std::size_t m_written;
+	bool m_failed;
+};
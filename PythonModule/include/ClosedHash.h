@@ -0,0 +1,118 @@
+/*
+ *  File: ClosedHash.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+/*
+ * Hash-indexed repository of closed item sets (similar to the subsumption check
+ * of CHARM). A superset with equal support has the same cover as the queried set,
+ * as the FP-tree does not keep the transaction ids the sets are indexed by
+ * (support, item) instead of (support, hash of cover). A query only has to check
+ * the sets of the shortest posting list of its items.
+ */
+
+#pragma once
+
+#include "Types.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+class ClosedHash
+{
+	DISABLE_COPY_ASSIGN_MOVE(ClosedHash)
+
+	using Key      = uint64_t;
+	using Postings = std::vector<uint32_t>;
+
+public:
+	ClosedHash() :
+		m_items(),
+		m_offsets(1, 0),
+		m_index()
+	{}
+
+	// Adds a closed set, the items have to be sorted in ascending order
+	void Add(const ItemID* pItems, const std::size_t& n, const Support& supp)
+	{
+		const uint32_t setIdx = static_cast<uint32_t>(m_offsets.size() - 1);
+
+		m_items.insert(std::end(m_items), pItems, pItems + n);
+		m_offsets.push_back(m_items.size());
+
+		for (std::size_t i = 0; i < n; i++)
+			m_index[makeKey(supp, pItems[i])].push_back(setIdx);
+	}
+
+	// Checks if a closed superset with the given support has been added before,
+	// the items have to be sorted in ascending order
+	bool HasSuperset(const ItemID* pItems, const std::size_t& n, const Support& supp) const
+	{
+		const Postings* pShortest = nullptr;
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			auto it = m_index.find(makeKey(supp, pItems[i]));
+
+			// No closed set with this support contains the item
+			if (it == m_index.end()) return false;
+
+			if (!pShortest || it->second.size() < pShortest->size())
+				pShortest = &it->second;
+		}
+
+		if (!pShortest) return false;
+
+		for (const uint32_t& setIdx : *pShortest)
+		{
+			const ItemID* pBegin = m_items.data() + m_offsets[setIdx];
+			const ItemID* pEnd   = m_items.data() + m_offsets[setIdx + 1];
+
+			if (static_cast<std::size_t>(pEnd - pBegin) < n) continue;
+
+			if (std::includes(pBegin, pEnd, pItems, pItems + n))
+				return true;
+		}
+
+		return false;
+	}
+
+	std::size_t GetCount() const
+	{
+		return m_offsets.size() - 1;
+	}
+
+private:
+	static Key makeKey(const Support& supp, const ItemID& item)
+	{
+		return (static_cast<Key>(supp) << 32) | (item & 0xFFFFFFFF);
+	}
+
+private:
+	std::vector<ItemID> m_items;
+	std::vector<std::size_t> m_offsets;
+	std::unordered_map<Key, Postings> m_index;
+};
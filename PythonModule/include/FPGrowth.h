@@ -26,14 +26,22 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
 #include <deque>
+#include <exception>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <queue>
+#include <random>
 #include <set>
 #include <signal.h>
 #include <stack>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #ifdef USE_OPENMP
@@ -56,37 +64,121 @@
 #include "Utils.h"
 
 #include "ClosedDetect.h"
+#include "ClosedHash.h"
+#include "FlatClosedTree.h"
 #include "FPTree.h"
 #include "FrequencyRef.h"
+#include "MaximalIndex.h"
+#include "PairMatrix.h"
 #include "Pattern.h"
+#include "PatternSpectrum.h"
 DEFINE_EXCEPTION(FPGException)
 
+// Output parameters of one job of a multi-job run (defaults as in the Python module)
+struct Job
+{
+	Support minSupport      = 10;
+	uint32_t minPatternLen  = 1;
+	uint32_t maxPatternLen  = 0;
+	uint32_t minNeuronCount = 1;
+	uint32_t maxSupport     = static_cast<uint32_t>(~0);
+};
+
+// Called for every finished top-level bucket during a pipelined growth
+using BucketConsumer = std::function<void(const Pattern&)>;
+
+// Called for every completed top-level bucket (index, bucket) by the growth threads before it is released, e.g., to checkpoint it
+using BucketWriter = std::function<void(const std::size_t&, const Pattern&)>;
+
+// Closedness check used to filter the generated pattern
+enum class ClosedAlgo
+{
+	CA_TREE = 0, // Prefix trees projected per item (ClosedDetect)
+	CA_HASH = 1, // Closed sets indexed by support and item (ClosedHash)
+	CA_FLAT = 2  // Prefix trees stored in shared flat arenas (FlatClosedDetect)
+};
+
+// Itemsets generated by the growth
+enum class Target
+{
+	TA_ALL        = 0, // All frequent itemsets (filtered afterwards, e.g., by the closed detection)
+	TA_MAXIMAL    = 1, // Only maximal itemsets, non-maximal subtrees are pruned during the growth
+	TA_COMPRESSED = 2  // All frequent itemsets, stored as (base, perfect extensions) and expanded by the consumer
+};
+
+// Cost of a full growth extrapolated from a sample of the top-level items (FPGrowth::Estimate)
+struct GrowthEstimate
+{
+	std::size_t sampled     = 0; // Mined top-level items
+	double patterns         = 0; // Itemsets generated by the growth (before the closed / maximal filter)
+	double growthTime       = 0; // Seconds, the items are assumed to be distributed evenly over the threads
+	double patternBytes     = 0; // Pattern blocks of all buckets, i.e., the peak without pipelining
+	std::size_t treeNodes   = 0;
+	std::size_t treeBytes   = 0; // Node pool of the tree
+	std::size_t threadBytes = 0; // Node pools of the conditional trees
+};
+
+// Cost of one top-level item of the growth
+struct BucketStats
+{
+	double seconds    = 0;
+	std::size_t nodes = 0; // Nodes of the conditional trees that are kept until the end of the growth
+};
+
 class FPGrowth
 {
 	DISABLE_COPY_ASSIGN_MOVE(FPGrowth)
+
+	// States of the top-level items in the item mask
+	static constexpr uint8_t ITEM_SKIP     = 0; // Not mined, e.g., outside of the sample of an estimation
+	static constexpr uint8_t ITEM_MINE     = 1;
+	static constexpr uint8_t ITEM_RESTORED = 2; // Not mined, the bucket was restored from a checkpoint
+
 public:
 	// Threads = 0 - Use maximal available amount of threads
 	// Threads = -1 or 1 disable multithreading, only use 1 thread
 	// Threads = x <= MAX_THREADS - Use x threads
 	// Threads = x > MAX_THREADS  - Use MAX_THREADS threads
-	FPGrowth(Transactions& transactions, const Support minSupport = 1, const uint32_t minPatternLen = 1, const uint32_t maxPatternLen = 0, const ItemC winLen = 20, const uint32_t maxc = -1, const uint32_t minneu = 1, const int32_t threads = 0) :
+	// SizeSupports[k] is the minimum support of the sets with k items (the last entry applies to all larger sets),
+	// if given the growth runs at the lowest of these supports for the valid pattern lengths
+	FPGrowth(Transactions& transactions, const Support minSupport = 1, const uint32_t minPatternLen = 1, const uint32_t maxPatternLen = 0, const ItemC winLen = 20, const uint32_t maxc = -1, const uint32_t minneu = 1, const int32_t threads = 0, const Target target = Target::TA_ALL, const uint32_t maxDuration = -1, const std::vector<Support>& sizeSupports = {}) :
 		m_minSupport(minSupport),
 		m_minPatternLen(minPatternLen),
 		m_maxPatternLen(maxPatternLen),
 		m_winLen(winLen),
 		m_maxSupport(maxc),
 		m_minNeuronCount(minneu),
+		m_target(target),
+		m_maxDuration(maxDuration),
+		m_sizeSupports(sizeSupports.empty() ? std::vector<Support>(1, minSupport) : sizeSupports),
+		m_sizeBounds(sizeBounds(sizeSupports, minPatternLen, maxPatternLen)),
+		m_build(),
+		m_pruned(),
 		m_tree(nullptr),
 		m_maxItemCnt(0),
 		m_objs(1),
 		m_pDataObjs(nullptr),
 		m_pIdx2Id(nullptr),
 		m_pId2Item(nullptr),
+		m_pId2Neuron(nullptr),
 		m_memory(65536),
 		m_pThreadMem(nullptr),
 		m_pPattern(nullptr),
 		m_pClosedDetect(nullptr),
-		m_initTime()
+		m_initTime(),
+		m_pipelined(false),
+		m_bucketMtx(),
+		m_bucketCv(),
+		m_bucketDone(),
+		m_bucketAbort(false),
+		m_consumedCnt(0),
+		m_itemMask(),
+		m_bucketStats(),
+		m_budgetTime(0),
+		m_budgetMem(0),
+		m_budgetExceeded(false),
+		m_completed(),
+		m_bucketWriter()
 	{
 #ifdef ALL_PATTERN
 #ifdef PERF_EXT_EXPANSION
@@ -97,6 +189,10 @@ public:
 #else
 		std::string mode = "Closed Itemsets";
 #endif
+		if (m_target == Target::TA_MAXIMAL)
+			mode = "Maximal Itemsets";
+		else if (m_target == Target::TA_COMPRESSED)
+			mode = "All Frequent Itemsets (Compressed)";
 #ifdef USE_MPI
 		mode += " - with MPI";
 #endif
@@ -108,6 +204,9 @@ public:
 
 		m_initTime.Start();
 
+		if (!m_sizeBounds.empty() && m_sizeBounds.back() != SUPP_MAX)
+			m_minSupport = m_sizeBounds.back();
+
 		frequency = getFrequency(transactions);
 
 		LOG_INFO << "Items: " << frequency.size() << std::endl;
@@ -116,11 +215,25 @@ public:
 		LOG_VERBOSE << "Reducing and sorting transactions ... " << std::flush;
 		timerSub.Start();
 
+		// Support of the items in the transactions that pass the filters, kept for the items removed
+		// by the support based reductions to decide if appended transactions require a rebuild
+		reduceTransactions(transactions);
+		const FrequencyMap candidates = getFrequency(transactions);
+
 		do
 		{
-			reduceTransactions(transactions);
-			frequency = getFrequency(transactions);
-		} while (reduceItems(transactions, frequency));
+			do
+			{
+				reduceTransactions(transactions);
+				frequency = getFrequency(transactions);
+			} while (reduceItems(transactions, frequency));
+		} while (reducePairs(transactions, frequency));
+
+		for (const auto& [item, supp] : candidates)
+		{
+			if (frequency.find(item) == frequency.end())
+				m_pruned.emplace(item, supp);
+		}
 
 		for (const Transaction& trans : transactions)
 		{
@@ -139,41 +252,13 @@ public:
 		timerSub.Start();
 		m_maxItemCnt = frequency.size();
 
-#ifdef USE_OPENMP
-		int32_t maxThreads = omp_get_num_threads();
-		if ((threads <= maxThreads && threads > 1))
-		{
-			LOG_INFO << "Limiting the number of threads to " << threads << std::endl;
-			omp_set_num_threads(threads);
-		}
-		else if (threads == 1 || threads == -1)
-		{
-			LOG_INFO << "Multi-threading disabled" << std::endl;
-			omp_set_num_threads(1);
-		}
-		else if (threads > maxThreads)
-			LOG_WARNING << "Set number of threads (" << threads << ") exceeds the maximal available number of threads (" << maxThreads << "), limiting to maximal number" << std::endl;
-
-		m_objs = omp_get_max_threads();
-		if (threads == 0 || threads > 1)
-			LOG_INFO << "Number of Threads: " << m_objs << std::endl;
-#else
-		UNUSED(threads);
-#endif
-
-		m_pDataObjs = new DataObjs[m_objs]();
-		m_pThreadMem = new FPNMemory[m_objs];
-
-		for (int32_t i = 0; i < m_objs; i++)
-		{
-			m_pDataObjs[i].Init(m_maxItemCnt);
-			m_pThreadMem[i].Init(65536);
-		}
+		initThreads(threads);
 
 		m_pPattern = new Pattern[m_maxItemCnt];
 
 		m_pIdx2Id = new uint32_t[m_maxItemCnt]();
 		m_pId2Item = new ItemC[m_maxItemCnt]();
+		m_pId2Neuron = new uint32_t[m_maxItemCnt]();
 
 		m_pClosedDetect = new ClosedDetect(m_maxItemCnt);
 
@@ -258,6 +343,10 @@ public:
 		for (TransactionC& trans : db)
 			m_tree->Add(trans, 1);
 
+		initNeurons();
+
+		m_build = { m_minSupport, m_minPatternLen, m_maxPatternLen, m_minNeuronCount, m_maxSupport };
+
 		m_initTime.Stop();
 		LOG_VERBOSE << "Creating Tree done after: " << m_initTime << std::endl;
 
@@ -275,10 +364,157 @@ public:
 		delete[] m_pPattern;
 		delete[] m_pIdx2Id;
 		delete[] m_pId2Item;
+		delete[] m_pId2Neuron;
 		delete m_tree;
 		delete m_pClosedDetect;
 	}
 
+	// Changes the parameters of the next growth on the existing tree. The tree only contains the items and
+	// transactions that passed the reduction with the parameters it was built with, hence, a query can only
+	// raise the support, zmin and min_neu. Returns false if the query is looser than the tree.
+	bool SetQuery(const Job& job, const Target target, const uint32_t maxDuration = -1, const std::vector<Support>& sizeSupports = {}, const int32_t threads = 0)
+	{
+		std::vector<Support> bounds = sizeBounds(sizeSupports, job.minPatternLen, job.maxPatternLen);
+		const Support minSupport    = (!bounds.empty() && bounds.back() != SUPP_MAX) ? bounds.back() : job.minSupport;
+
+		if (minSupport < m_build.minSupport || job.minPatternLen < m_build.minPatternLen || job.minNeuronCount < m_build.minNeuronCount) return false;
+
+		m_minSupport     = minSupport;
+		m_minPatternLen  = job.minPatternLen;
+		m_maxPatternLen  = job.maxPatternLen;
+		m_minNeuronCount = job.minNeuronCount;
+		m_maxSupport     = job.maxSupport;
+		m_target         = target;
+		m_maxDuration    = maxDuration;
+		m_sizeSupports   = sizeSupports.empty() ? std::vector<Support>(1, job.minSupport) : sizeSupports;
+		m_sizeBounds     = std::move(bounds);
+
+		for (std::size_t i = 0; i < m_maxItemCnt; i++)
+			m_pPattern[i].Clear();
+
+		delete m_pClosedDetect;
+		m_pClosedDetect = new ClosedDetect(m_maxItemCnt);
+
+		initThreads(threads);
+		return true;
+	}
+
+	// Appends transactions (e.g., the new time bins of a growing recording) to the tree, the cost depends on the
+	// new transactions (and the size of the tree if the item order has to be repaired) instead of the whole database.
+	// Items removed by the support based reductions at build time are not part of the tree, hence, if one of them
+	// could become frequent false is returned and the tree is left unchanged, it has to be rebuilt in this case.
+	// The result of the next growth includes the appended transactions.
+	bool Append(Transactions& transactions, const bool forceRerank = false)
+	{
+		Timer timer;
+		timer.Start();
+
+		std::vector<ItemC> neurons;
+		std::experimental::erase_if(transactions, [this, &neurons](const Transaction& t) {
+			return !canSupportPattern(t, m_build.minPatternLen, m_build.minNeuronCount, neurons);
+		});
+
+		std::unordered_map<ItemC, std::size_t> item2Id;
+		for (std::size_t id = 0; id < m_maxItemCnt; id++)
+			item2Id.emplace(m_pId2Item[id], id);
+
+		const FrequencyMap frequency = getFrequency(transactions);
+		FrequencyMap added;
+
+		for (const auto& [item, supp] : frequency)
+		{
+			if (item2Id.find(item) != item2Id.end()) continue;
+
+			const auto it = m_pruned.find(item);
+			if (it == m_pruned.end())
+				added.emplace(item, supp);
+			else if (it->second + supp >= m_build.minSupport)
+			{
+				LOG_INFO << "Item " << item << " removed at build time may become frequent, the tree has to be rebuilt" << std::endl;
+				return false;
+			}
+		}
+
+		// Items that were never seen before are completely known, hence, they are added to the tree.
+		// The removed items stay infrequent and are removed from the transactions again.
+		for (const auto& [item, supp] : frequency)
+		{
+			const auto it = m_pruned.find(item);
+			if (it != m_pruned.end()) it->second += supp;
+		}
+
+		for (Transaction& trans : transactions)
+			std::experimental::erase_if(trans, [this](const ItemC& item) { return m_pruned.find(item) != m_pruned.end(); });
+
+		std::experimental::erase_if(transactions, [this, &neurons](const Transaction& t) {
+			return !canSupportPattern(t, m_build.minPatternLen, m_build.minNeuronCount, neurons);
+		});
+
+		if (!added.empty())
+		{
+			std::vector<ItemC> items;
+			for (const auto& [item, supp] : added)
+				items.push_back(item);
+
+			std::sort(std::begin(items), std::end(items), [&added](const ItemC& a, const ItemC& b) {
+				if (added.at(a) != added.at(b)) return added.at(a) > added.at(b);
+				return a > b;
+			});
+
+			for (const ItemC& item : items)
+				item2Id.emplace(item, item2Id.size());
+
+			addItems(items);
+		}
+
+		std::vector<std::vector<std::size_t>> db;
+		for (const Transaction& trans : transactions)
+		{
+			std::vector<std::size_t> ids;
+			for (const ItemC& item : trans)
+				ids.push_back(item2Id[item]);
+
+			std::sort(std::begin(ids), std::end(ids));
+			db.push_back(std::move(ids));
+		}
+
+		std::sort(std::begin(db), std::end(db));
+
+		for (const std::vector<std::size_t>& ids : db)
+		{
+			for (const std::size_t& id : ids)
+				m_tree->pHeads[id].support++;
+
+			m_tree->Add(ids.data(), ids.size(), 1);
+		}
+
+		const bool reranked = forceRerank || rankDrifted();
+		if (reranked) rerank();
+
+		timer.Stop();
+		LOG_VERBOSE << "Appended " << db.size() << " transactions (" << added.size() << " new items" << (reranked ? ", reranked" : "") << ") after: " << timer << std::endl;
+		return true;
+	}
+
+	// Raises the minimum support while the growth is running (e.g., by a top-k selection), the items and sets below
+	// it are pruned from then on. The growth threads only read the support, hence, the update is lock-free.
+	void RaiseMinSupport(const Support& supp)
+	{
+		Support cur = m_minSupport.load(std::memory_order_relaxed);
+		while (cur < supp && !m_minSupport.compare_exchange_weak(cur, supp, std::memory_order_relaxed)) {}
+	}
+
+	Support GetMinSupport() const
+	{
+		return m_minSupport.load(std::memory_order_relaxed);
+	}
+
+	// Parameters the tree was built with
+	const Job& GetBuildParams() const
+	{
+		return m_build;
+	}
+
 	const uint32_t& GetMinPatternLen() const
 	{
 		return m_minPatternLen;
@@ -289,6 +525,37 @@ public:
 		return m_maxPatternLen;
 	}
 
+	const ItemC& GetWinLen() const
+	{
+		return m_winLen;
+	}
+
+	const uint32_t& GetMaxSupport() const
+	{
+		return m_maxSupport;
+	}
+
+	const uint32_t& GetMinNeuronCount() const
+	{
+		return m_minNeuronCount;
+	}
+
+	const uint32_t& GetMaxDuration() const
+	{
+		return m_maxDuration;
+	}
+
+	const std::vector<Support>& GetSizeSupports() const
+	{
+		return m_sizeSupports;
+	}
+
+	// Checks if a set of the given length satisfies the minimum support of its size
+	bool AcceptSizeSupport(const std::size_t& len, const Support& supp) const
+	{
+		return supp >= m_sizeSupports[std::min(len, m_sizeSupports.size() - 1)];
+	}
+
 	const std::size_t& GetItemCount() const
 	{
 		return m_maxItemCnt;
@@ -319,185 +586,719 @@ public:
 		return m_pPattern;
 	}
 
-private:
-	bool project(const int32_t& tId, FPTree* pDst, const FPTree* pSrc, const std::size_t& id)
+	// Pipelined growth: The top-level items are processed in descending order and every
+	// finished bucket is handed to the consumer (running in a dedicated thread) in the order
+	// required by the closed detection, afterwards the bucket is released. This overlaps the
+	// growth with the consumer and caps the amount of pattern memory held at once.
+	bool Growth(const BucketConsumer& consumer)
 	{
-		memset(m_pDataObjs[tId].m_pSubs, 0, id * sizeof(Support));
-		FPNode* pNode;
-		FPNode* pAnc;
-
-		for (pNode = pSrc->pHeads[id].list; pNode; pNode = pNode->succ)
-		{
-			for (pAnc = pNode->parent; pAnc->id != IDX_MAX; pAnc = pAnc->parent)
-			{
-				m_pDataObjs[tId].m_pSubs[pAnc->id] += pNode->support;
-			}
-		}
+#ifdef USE_MPI
+		// The buckets are only complete after they have been gathered on the root rank
+		const Pattern* pPattern = Growth();
+		if (pPattern == nullptr) return false;
 
-		Support n = 0;
-		FPHead* pH;
+		for (int64_t i = static_cast<int64_t>(m_tree->cnt) - 1; i > -1; i--)
+			consumer(pPattern[i]);
 
-		for (std::size_t i = 0; i < id; i++)
-		{
-			if (m_pDataObjs[tId].m_pSubs[i] < m_minSupport)
-			{
-				// Invalidate
-				m_pDataObjs[tId].m_pSubs[i] = SUPP_MAX;
-				continue;
-			}
+		return true;
+#else
+		Timer t;
+		t.Start();
 
-			pH = pDst->pHeads + n;
-			pH->item = pSrc->pHeads[i].item;
-			pH->support = m_pDataObjs[tId].m_pSubs[i];
-			pH->list = nullptr;
-			pH->pMemory = pSrc->pMemory;
-			m_pDataObjs[tId].m_pSubs[i] = n++;
-		}
+		m_pipelined   = true;
+		m_bucketAbort = false;
+		m_consumedCnt = 0;
+		m_bucketDone.assign(m_tree->cnt, false);
 
-		if (n == 0) return false;
+		std::exception_ptr pConsumerExcept = nullptr;
 
-		// As the Tree is reused for several iterations initialize cnt and root support here
-		pDst->cnt = n;
-		pDst->root.support = 0;
+		std::thread consumerThread([this, &consumer, &pConsumerExcept]() {
+			try
+			{
+				for (int64_t i = static_cast<int64_t>(m_tree->cnt) - 1; i > -1; i--)
+				{
+					if (!waitForBucket(i)) return;
 
-		std::size_t i;
-		for (pNode = pSrc->pHeads[id].list; pNode; pNode = pNode->succ)
-		{
-			std::size_t* d = m_pDataObjs[tId].m_pMap + id;
-			for (pAnc = pNode->parent; pAnc->id != IDX_MAX; pAnc = pAnc->parent)
+					consumer(m_pPattern[i]);
+					m_consumedCnt += m_pPattern[i].GetCount();
+					m_pPattern[i].Clear();
+				}
+			}
+			catch (...)
 			{
-				if ((i = m_pDataObjs[tId].m_pSubs[pAnc->id]) != SUPP_MAX)
-					*--d = i;
+				pConsumerExcept = std::current_exception();
+				abortBuckets();
 			}
+		});
 
-			pDst->Add(d, (m_pDataObjs[tId].m_pMap + id) - d, pNode->support);
+		try
+		{
+			growthTop(m_tree);
+		}
+		catch (...)
+		{
+			abortBuckets();
+			consumerThread.join();
+			m_pipelined = false;
+			throw;
 		}
 
-		return true;
-	}
+		consumerThread.join();
+		m_pipelined = false;
 
-	void beginPattern(const int32_t& tId)
-	{
-		if (!m_pDataObjs[tId].m_patternOpen)
-		{
-			m_pDataObjs[tId].m_patternOpen = true;
-			std::memset(m_pDataObjs[tId].m_pAdded, 0, m_maxItemCnt);
-			std::memset(m_pDataObjs[tId].m_pAddedPerfExt, 0, m_maxItemCnt);
-			m_pDataObjs[tId].m_lastIDCnt = 0;
-			m_pDataObjs[tId].m_perfExtIDCnt = 0;
-#ifdef DEBUG
-			LOG_DEBUG << std::endl
-				<< std::endl
-				<< "--- BEGIN PATTERN ---" << std::endl;
+		if (pConsumerExcept) std::rethrow_exception(pConsumerExcept);
+
+		t.Stop();
+		LOG_INFO_EVAL << "\x1B[31mRuntime:\x1B[0m " << t + m_initTime << " - Frequent Item-Sets: " << m_consumedCnt << std::endl;
+		return true;
 #endif
-		}
 	}
 
-	bool addPatternElement(const int32_t& tId, const ItemID& item, const Support& supp)
+	// Estimates the cost of Growth() by mining a sample of the top-level items. The cost of an item mainly depends on
+	// its conditional pattern base, hence, the items are sorted by its size (sum of the depths of their nodes) and split
+	// into equally sized strata. One random item of every stratum is mined and its cost is scaled by the pattern base
+	// of the whole stratum. The conditional trees of the top level are kept in the node pools of the threads until the
+	// end of the growth, hence, their nodes are extrapolated as well. The buckets of the sample are released afterwards.
+	GrowthEstimate Estimate(const std::size_t& samples, const uint32_t& seed)
 	{
-		if (supp < m_minSupport) return true;
-		if (!m_pDataObjs[tId].m_patternOpen) return true;
+		GrowthEstimate est;
+		const std::size_t cnt = m_tree->cnt;
 
-		if (!m_pDataObjs[tId].m_pAddedPerfExt[item] && !m_pDataObjs[tId].m_pAdded[item])
+		std::vector<double> base(cnt, 0);
+		std::vector<std::size_t> order;
+
+		for (std::size_t i = 0; i < cnt; i++)
 		{
-#ifdef DEBUG
-			LOG_DEBUG << "itemID=" << item << "; item=" << (char)m_pId2Item[item] << "; supp=" << supp << std::endl;
-#endif
-			if (m_pClosedDetect->Add(item, supp) > 0)
-			{
-				m_pDataObjs[tId].m_pAdded[item] = true;
-				m_pDataObjs[tId].m_pSupports[m_pDataObjs[tId].m_lastIDCnt] = supp;
-				m_pDataObjs[tId].m_pLastID[m_pDataObjs[tId].m_lastIDCnt++] = item;
+			for (const FPNode* pNode = m_tree->pHeads[i].list; pNode; pNode = pNode->succ)
+				base[i] += static_cast<double>(pNode->depth);
 
-				if (m_pDataObjs[tId].m_lastIDCnt >= m_maxItemCnt) LOG_ERROR << "ERROR: lastIDCnt >= maxItemCnt" << std::endl;
-			}
-			else
-				return false;
+			// Items that are not frequent for the query are skipped by the growth
+			if (m_tree->pHeads[i].support >= GetMinSupport()) order.push_back(i);
 		}
 
-		return true;
-	}
+		std::sort(std::begin(order), std::end(order), [&base](const std::size_t& a, const std::size_t& b) { return base[a] < base[b]; });
 
-	void addPerfectExt(const int32_t& tId, const ItemID& item, const Support& supp)
-	{
-		if (supp < m_minSupport) return;
-		if (!m_pDataObjs[tId].m_patternOpen) return;
+		// Stratum s contains the items order[bounds[s]] to order[bounds[s + 1] - 1]
+		const std::size_t strata = std::min(std::max<std::size_t>(samples, 1), order.size());
+		std::vector<std::size_t> bounds(strata + 1);
+		for (std::size_t s = 0; s <= strata; s++)
+			bounds[s] = (strata > 0) ? s * order.size() / strata : 0;
 
-		if (!m_pDataObjs[tId].m_pAddedPerfExt[item] && !m_pDataObjs[tId].m_pAdded[item])
+		std::vector<std::size_t> picked(strata);
+		std::mt19937 gen(seed);
+
+		m_itemMask.assign(cnt, ITEM_SKIP);
+		m_bucketStats.assign(cnt, BucketStats());
+
+		for (std::size_t s = 0; s < strata; s++)
 		{
-			m_pDataObjs[tId].m_pAddedPerfExt[item] = true;
-			m_pDataObjs[tId].m_pPerfExtIDs[m_pDataObjs[tId].m_perfExtIDCnt++] = item;
+			std::uniform_int_distribution<std::size_t> dist(bounds[s], bounds[s + 1] - 1);
+			picked[s]             = order[dist(gen)];
+			m_itemMask[picked[s]] = ITEM_MINE;
 		}
-	}
-
-	void pp(Pattern& results, const ItemID* pIDs, const std::size_t& size, const std::size_t& pos, const std::size_t& minLen, PatternType* pBase, std::size_t basePos, const Support& supp, const ItemC* pId2Item, const Support& maxSupport, const std::size_t& minNeuronCount, const ItemC& winLen)
-	{
-		pBase[basePos++] = m_pId2Item[pIDs[pos]];
-		for (std::size_t i = pos + 1; i < size; i++)
-			pp(results, pIDs, size, i, minLen, pBase, basePos, supp, pId2Item, maxSupport, minNeuronCount, winLen);
 
-		if (basePos >= minLen)
-			results.AddPattern(basePos, supp, pBase, pId2Item, maxSupport, minNeuronCount, winLen);
-	}
+		Timer t;
+		t.Start();
 
-	void endLocalPattern(const int32_t& tId, const int64_t& pId, const ItemID& item)
-	{
-		UNUSED(item);
-		if (m_pDataObjs[tId].m_patternOpen)
+		try
 		{
-			size_t combLength = m_pDataObjs[tId].m_lastIDCnt + m_pDataObjs[tId].m_perfExtIDCnt;
-			if (combLength >= m_minPatternLen && (m_maxPatternLen == 0 || combLength <= m_maxPatternLen))
-			{
-				Support s = m_pDataObjs[tId].m_pSupports[m_pDataObjs[tId].m_lastIDCnt - 1];
-#ifdef ALL_PATTERN
-				for (std::size_t i = 0; i < m_pDataObjs[tId].m_lastIDCnt; i++)
-					m_pDataObjs[tId].m_pPatternBase[i] = m_pDataObjs[tId].m_pLastID[i] | (static_cast<ItemID>(m_pDataObjs[tId].m_pSupports[i]) << 32);
+			growthTop(m_tree);
+		}
+		catch (...)
+		{
+			m_itemMask.clear();
+			m_bucketStats.clear();
+			throw;
+		}
 
-#ifdef PERF_EXT_EXPANSION
-				// TODO: Add maxPatternLength
-				for (std::size_t i = 0; i < m_pDataObjs[tId].m_perfExtIDCnt; i++)
-					pp(m_pPattern[pId], m_pDataObjs[tId].m_pPerfExtIDs, m_pDataObjs[tId].m_perfExtIDCnt, i, m_minPatternLen, m_pDataObjs[tId].m_pPatternBase, static_cast<ItemC>(m_pDataObjs[tId].m_lastIDCnt), s, GetId2Item(), m_maxSupport, m_minNeuronCount, m_winLen);
+		t.Stop();
 
-				if (m_pDataObjs[tId].m_lastIDCnt >= m_minPatternLen && (m_maxPatternLen == 0 || m_pDataObjs[tId].m_lastIDCnt <= m_maxPatternLen))
-					m_pPattern[pId].AddPattern(static_cast<ItemC>(m_pDataObjs[tId].m_lastIDCnt), s, m_pDataObjs[tId].m_pPatternBase, GetId2Item(), m_maxSupport, m_minNeuronCount, m_winLen);
+		double growthTime = 0;
+		double nodes      = 0;
+		std::size_t transientBytes = 0;
+
+		for (std::size_t s = 0; s < strata; s++)
+		{
+			const std::size_t first = bounds[s];
+			const std::size_t last  = bounds[s + 1];
+			const std::size_t i     = picked[s];
+
+			double stratumBase = 0;
+			for (std::size_t j = first; j < last; j++)
+				stratumBase += base[order[j]];
+
+			const double scale = (base[i] > 0) ? stratumBase / base[i] : static_cast<double>(last - first);
+
+			est.patterns += static_cast<double>(m_pPattern[i].GetCount()) * scale;
+			est.patternBytes += static_cast<double>(m_pPattern[i].GetBytes()) * scale;
+			growthTime += m_bucketStats[i].seconds * scale;
+			nodes += static_cast<double>(m_bucketStats[i].nodes) * scale;
+
+			m_pPattern[i].Clear();
+		}
+
+		// Blocks beyond the kept nodes are used by the deeper levels of the growth
+		for (int32_t i = 0; i < m_objs; i++)
+			transientBytes = std::max(transientBytes, m_pThreadMem[i].GetBytes() - m_pThreadMem[i].GetInUse() * sizeof(FPNode));
+
+		est.sampled     = strata;
+		est.growthTime  = growthTime / m_objs;
+		est.treeNodes   = m_memory.GetInUse();
+		est.treeBytes   = m_memory.GetBytes();
+		est.threadBytes = static_cast<std::size_t>(nodes) * sizeof(FPNode) + transientBytes * static_cast<std::size_t>(m_objs);
+
+		m_itemMask.clear();
+		m_bucketStats.clear();
+
+		LOG_INFO << "Estimation: " << strata << " / " << order.size() << " items mined after: " << t << std::endl;
+		return est;
+	}
+
+	const Timer& GetInitTime() const
+	{
+		return m_initTime;
+	}
+
+	// Anytime growth: Once the growth ran for the given seconds or the process uses more than the given memory,
+	// no further top-level items are started and the growth returns after the running items are finished (0 disables
+	// a limit). The items are started in descending order, every set of a finished bucket only has supersets in the
+	// finished buckets, hence, the result contains exactly the closed / maximal sets whose least frequent item is one
+	// of the completed items.
+	void SetBudget(const double& seconds, const uint64_t& memBytes)
+	{
+		m_budgetTime = seconds;
+		m_budgetMem  = memBytes;
+	}
+
+	bool BudgetExceeded() const
+	{
+		return m_budgetExceeded;
+	}
+
+	void SetBucketWriter(const BucketWriter& writer)
+	{
+		m_bucketWriter = writer;
+	}
+
+	// Restores the bucket of the top-level item i (e.g., from a checkpoint), the item is not mined by the next growth.
+	// The data consists of the records of the bucket (length, support, items). Returns false if the data is invalid.
+	bool RestoreBucket(const std::size_t& i, PatternType* pData, const std::size_t& words)
+	{
+		if (i >= m_tree->cnt) return false;
+
+		for (std::size_t off = 0; off < words; off += pData[off] + Pattern::OFFSET)
+		{
+			if (off + Pattern::OFFSET > words || pData[off] > words - off - Pattern::OFFSET) return false;
+		}
+
+		if (m_itemMask.empty()) m_itemMask.assign(m_tree->cnt, ITEM_MINE);
+		m_itemMask[i] = ITEM_RESTORED;
+
+		m_pPattern[i].Clear();
+		for (std::size_t off = 0; off < words; off += pData[off] + Pattern::OFFSET)
+			m_pPattern[i].AddPattern(pData[off + Pattern::LEN_IDX], static_cast<Support>(pData[off + Pattern::SUPP_IDX]), pData + off + Pattern::DATA_IDX);
+
+		return true;
+	}
+
+	// Encodes the tree: item count, per item (item, support), root support and per item the nodes in the order of their
+	// creation as (index of the parent, support), the root has index 0 and the nodes are numbered in the encoded order.
+	// Every parent has a lower id than its children, hence, it is encoded before them.
+	void WriteTree(std::ostream& os) const
+	{
+		const auto write = [&os](const uint64_t& val) { os.write(reinterpret_cast<const char*>(&val), sizeof(uint64_t)); };
+
+		write(m_tree->cnt);
+		for (std::size_t id = 0; id < m_tree->cnt; id++)
+		{
+			write(m_pId2Item[id]);
+			write(m_tree->pHeads[id].support);
+		}
+
+		write(m_tree->root.support);
+
+		std::unordered_map<const FPNode*, uint64_t> index;
+		index.emplace(&m_tree->root, 0);
+
+		std::vector<const FPNode*> nodes;
+		for (std::size_t id = 0; id < m_tree->cnt; id++)
+		{
+			nodes.clear();
+			for (const FPNode* pNode = m_tree->pHeads[id].list; pNode; pNode = pNode->succ)
+				nodes.push_back(pNode);
+
+			write(nodes.size());
+			for (auto it = nodes.rbegin(); it != nodes.rend(); it++)
+			{
+				write(index.at((*it)->parent));
+				write((*it)->support);
+				index.emplace(*it, index.size());
+			}
+		}
+	}
+
+	// Replaces the tree by an encoded one (WriteTree), the object has to be built from an empty database with the
+	// parameters of the encoded tree. Returns false if the data is invalid.
+	bool ReadTree(std::istream& is)
+	{
+		const auto read = [&is](uint64_t& val) { return static_cast<bool>(is.read(reinterpret_cast<char*>(&val), sizeof(uint64_t))); };
+
+		uint64_t cnt = 0;
+		if (m_maxItemCnt != 0 || !read(cnt)) return false;
+
+		std::vector<ItemC> items(cnt);
+		std::vector<Support> supports(cnt);
+
+		for (uint64_t id = 0; id < cnt; id++)
+		{
+			uint64_t item = 0;
+			uint64_t supp = 0;
+			if (!read(item) || !read(supp)) return false;
+
+			items[id]    = static_cast<ItemC>(item);
+			supports[id] = static_cast<Support>(supp);
+		}
+
+		uint64_t rootSupp = 0;
+		if (!read(rootSupp)) return false;
+
+		addItems(items);
+
+		for (std::size_t id = 0; id < cnt; id++)
+			m_tree->pHeads[id].support = supports[id];
+
+		m_tree->root.support = static_cast<Support>(rootSupp);
+
+		std::vector<FPNode*> nodes(1, &m_tree->root);
+		for (std::size_t id = 0; id < cnt; id++)
+		{
+			uint64_t n = 0;
+			if (!read(n)) return false;
+
+			for (uint64_t k = 0; k < n; k++)
+			{
+				uint64_t parent = 0;
+				uint64_t supp   = 0;
+				if (!read(parent) || !read(supp) || parent >= nodes.size() || (parent > 0 && nodes[parent]->id >= id)) return false;
+
+				FPNode* pNode  = m_memory.Alloc();
+				pNode->id      = id;
+				pNode->support = static_cast<Support>(supp);
+				pNode->depth   = nodes[parent]->depth + 1;
+				pNode->parent  = nodes[parent];
+				pNode->succ    = m_tree->pHeads[id].list;
+#ifdef DEBUG
+				pNode->item = items[id];
+#endif
+				m_tree->pHeads[id].list = pNode;
+				nodes.push_back(pNode);
+			}
+		}
+
+		LOG_VERBOSE << "Restored Tree: " << cnt << " Items, " << nodes.size() - 1 << " Nodes" << std::endl;
+		return true;
+	}
+
+	// Top-level items (not their ids) that were mined completely by the last growth
+	std::vector<ItemC> GetCompletedItems() const
+	{
+		std::vector<ItemC> items;
+		for (int64_t i = static_cast<int64_t>(m_completed.size()) - 1; i > -1; i--)
+			if (m_completed[i]) items.push_back(m_pId2Item[m_tree->pHeads[i].item]);
+
+		return items;
+	}
+
+private:
+	bool project(const int32_t& tId, FPTree* pDst, const FPTree* pSrc, const std::size_t& id)
+	{
+		memset(m_pDataObjs[tId].m_pSubs, 0, id * sizeof(Support));
+		FPNode* pNode;
+		FPNode* pAnc;
+
+		// Paths that are too short to extend the current set to zmin items cannot contain a reported
+		// pattern, hence, they are excluded from the conditional tree. The closed filter requires the
+		// exact support of every prefix, therefore, for closed sets only the projection is skipped if
+		// there is no sufficiently long path.
+		std::size_t minDepth = (m_minPatternLen > m_pDataObjs[tId].m_lastIDCnt) ? m_minPatternLen - m_pDataObjs[tId].m_lastIDCnt + 1 : 0;
+
+		if (m_target == Target::TA_ALL && minDepth > 1)
+		{
+			for (pNode = pSrc->pHeads[id].list; pNode && pNode->depth < minDepth; pNode = pNode->succ) {}
+			if (!pNode) return false;
+			minDepth = 0;
+		}
+
+		for (pNode = pSrc->pHeads[id].list; pNode; pNode = pNode->succ)
+		{
+			if (pNode->depth < minDepth) continue;
+
+			for (pAnc = pNode->parent; pAnc->id != IDX_MAX; pAnc = pAnc->parent)
+			{
+				m_pDataObjs[tId].m_pSubs[pAnc->id] += pNode->support;
+			}
+		}
+
+		// Items that would exceed the maximal duration together with the current set are dropped
+		if (hasMaxDuration())
+		{
+			ItemC lo, hi;
+			lagRange(tId, false, lo, hi);
+			for (std::size_t i = 0; i < id; i++)
+				if (!fitsDuration(lo, hi, pSrc->pHeads[i].item)) m_pDataObjs[tId].m_pSubs[i] = 0;
+		}
+
+		// The maximal target checks the filters on its head union tail after the projection
+		if (m_target != Target::TA_MAXIMAL && !canPassFilters(tId, pSrc, id)) return false;
+
+		// With size dependent supports the items are only kept if one of the reachable sizes can be
+		// satisfied, the maximal target needs all frequent sets for the maximality
+		const Support minSupport = (m_target == Target::TA_MAXIMAL) ? m_pDataObjs[tId].m_minSupport : projectionSupport(tId, id);
+
+		Support n = 0;
+		FPHead* pH;
+
+		for (std::size_t i = 0; i < id; i++)
+		{
+			if (m_pDataObjs[tId].m_pSubs[i] < minSupport)
+			{
+				// Invalidate
+				m_pDataObjs[tId].m_pSubs[i] = SUPP_MAX;
+				continue;
+			}
+
+			pH = pDst->pHeads + n;
+			pH->item = pSrc->pHeads[i].item;
+			pH->support = m_pDataObjs[tId].m_pSubs[i];
+			pH->list = nullptr;
+			pH->pMemory = pSrc->pMemory;
+			m_pDataObjs[tId].m_pSubs[i] = n++;
+		}
+
+		if (n == 0) return false;
+
+		// As the Tree is reused for several iterations initialize cnt and root support here
+		pDst->cnt = n;
+		pDst->root.support = 0;
+
+		std::size_t i;
+		for (pNode = pSrc->pHeads[id].list; pNode; pNode = pNode->succ)
+		{
+			if (pNode->depth < minDepth) continue;
+
+			std::size_t* d = m_pDataObjs[tId].m_pMap + id;
+			for (pAnc = pNode->parent; pAnc->id != IDX_MAX; pAnc = pAnc->parent)
+			{
+				if ((i = m_pDataObjs[tId].m_pSubs[pAnc->id]) != SUPP_MAX)
+					*--d = i;
+			}
+
+			pDst->Add(d, (m_pDataObjs[tId].m_pMap + id) - d, pNode->support);
+		}
+
+		return true;
+	}
+
+	// Minimum support of the items in the conditional tree of item id: Its sets contain the current set plus
+	// up to one item per frequent conditional item, an item is only required if its support satisfies
+	// the (non-increasing) bound of the largest of these sizes. Removing items lowers the reachable size,
+	// therefore, the support is raised until it is stable.
+	Support projectionSupport(const int32_t& tId, const std::size_t& id) const
+	{
+		Support minSupport = m_pDataObjs[tId].m_minSupport;
+		if (m_sizeBounds.empty()) return minSupport;
+
+		const DataObjs& d = m_pDataObjs[tId];
+
+		while (true)
+		{
+			std::size_t cnt = d.m_lastIDCnt;
+			for (std::size_t i = 0; i < id; i++)
+				if (d.m_pSubs[i] >= minSupport) cnt++;
+
+			const Support bound = m_sizeBounds[std::min(cnt, m_sizeBounds.size() - 1)];
+			if (bound <= minSupport) return minSupport;
+
+			minSupport = bound;
+		}
+	}
+
+	// Checks if any set in the conditional tree of item id can pass the output filters, i.e.,
+	// if the current set (including its perfect extensions) plus all items frequent in that
+	// tree contain a lag-0 item and at least min_neu distinct neurons. Otherwise, the
+	// projection can be skipped, the support counters of the items have to be set already.
+	bool canPassFilters(const int32_t& tId, const FPTree* pSrc, const std::size_t& id)
+	{
+		DataObjs& d = m_pDataObjs[tId];
+		std::size_t cnt = 0;
+		bool anchor = false;
+
+		if (++d.m_neuronStamp == 0)
+		{
+			std::memset(d.m_pNeuronMark, 0, m_maxItemCnt * sizeof(uint32_t));
+			d.m_neuronStamp = 1;
+		}
+
+		auto mark = [&](const ItemID& item) {
+			if (!anchor) anchor = (m_pId2Item[item] % m_winLen) == 0;
+
+			if (cnt < m_minNeuronCount)
+			{
+				uint32_t& m = d.m_pNeuronMark[m_pId2Neuron[item]];
+				if (m != d.m_neuronStamp)
+				{
+					m = d.m_neuronStamp;
+					cnt++;
+				}
+			}
+
+			return anchor && cnt >= m_minNeuronCount;
+		};
+
+		for (std::size_t i = 0; i < d.m_lastIDCnt; i++)
+			if (mark(d.m_pLastID[i])) return true;
+
+		for (std::size_t i = 0; i < d.m_perfExtIDCnt; i++)
+			if (mark(d.m_pPerfExtIDs[i])) return true;
+
+		for (std::size_t i = 0; i < id; i++)
+			if (d.m_pSubs[i] >= d.m_minSupport && mark(pSrc->pHeads[i].item)) return true;
+
+		return false;
+	}
+
+	// Spans above winLen - 1 cannot occur, i.e., do not restrict the sets
+	bool hasMaxDuration() const
+	{
+		return m_maxDuration < m_winLen - 1;
+	}
+
+	// Lag range (item % winLen) of the current set, optionally including its perfect extensions
+	void lagRange(const int32_t& tId, const bool& withPerfExt, ItemC& lo, ItemC& hi) const
+	{
+		const DataObjs& d = m_pDataObjs[tId];
+		lo = m_winLen;
+		hi = 0;
+
+		for (std::size_t i = 0; i < d.m_lastIDCnt; i++)
+		{
+			lo = std::min(lo, m_pId2Item[d.m_pLastID[i]] % m_winLen);
+			hi = std::max(hi, m_pId2Item[d.m_pLastID[i]] % m_winLen);
+		}
+
+		for (std::size_t i = 0; withPerfExt && i < d.m_perfExtIDCnt; i++)
+		{
+			lo = std::min(lo, m_pId2Item[d.m_pPerfExtIDs[i]] % m_winLen);
+			hi = std::max(hi, m_pId2Item[d.m_pPerfExtIDs[i]] % m_winLen);
+		}
+	}
+
+	bool fitsDuration(const ItemC& lo, const ItemC& hi, const ItemID& item) const
+	{
+		const ItemC lag = m_pId2Item[item] % m_winLen;
+		return std::max(hi, lag) - std::min(lo, lag) <= m_maxDuration;
+	}
+
+	// Calls func(pExt, extCnt) with the perfect extensions of the current set. With a maximal duration
+	// the extensions only fit the set individually, if they do not fit together they are split into the
+	// maximal windows [w, w + maxDuration] of lags covering the set. The compressed target checks every
+	// expansion individually and keeps all extensions.
+	template<typename Func>
+	void forEachExtWindow(const int32_t& tId, Func func)
+	{
+		DataObjs& d = m_pDataObjs[tId];
+		ItemC lo, hi;
+
+		if (hasMaxDuration() && m_target != Target::TA_COMPRESSED && d.m_perfExtIDCnt > 0)
+			lagRange(tId, true, lo, hi);
+
+		if (!hasMaxDuration() || m_target == Target::TA_COMPRESSED || d.m_perfExtIDCnt == 0 || hi - lo <= m_maxDuration)
+		{
+			func(d.m_pPerfExtIDs, d.m_perfExtIDCnt);
+			return;
+		}
+
+		lagRange(tId, false, lo, hi);
+
+		const auto hasLag = [&](const ItemC& lag) {
+			return std::any_of(d.m_pPerfExtIDs, d.m_pPerfExtIDs + d.m_perfExtIDCnt, [&](const ItemID& i) { return m_pId2Item[i] % m_winLen == lag; });
+		};
+
+		const ItemC first = (hi > m_maxDuration) ? hi - m_maxDuration : 0;
+		for (ItemC w = first; w <= lo; w++)
+		{
+			// Skip windows contained in their predecessor or strictly contained in their successor
+			if (w > first && !hasLag(w + m_maxDuration)) continue;
+			if (w < lo && !hasLag(w) && hasLag(w + 1 + m_maxDuration)) continue;
+
+			std::size_t n = 0;
+			for (std::size_t i = 0; i < d.m_perfExtIDCnt; i++)
+			{
+				const ItemC lag = m_pId2Item[d.m_pPerfExtIDs[i]] % m_winLen;
+				if (lag >= w && lag <= w + m_maxDuration) d.m_pWindowIDs[n++] = d.m_pPerfExtIDs[i];
+			}
+
+			func(d.m_pWindowIDs, n);
+		}
+	}
+
+	// Maps the items to consecutive neuron indices (item / winLen) for the neuron bound
+	void initNeurons()
+	{
+		std::map<ItemC, uint32_t> neurons;
+
+		for (std::size_t i = 0; i < m_maxItemCnt; i++)
+		{
+			auto it = neurons.try_emplace(m_pId2Item[i] / m_winLen, static_cast<uint32_t>(neurons.size())).first;
+			m_pId2Neuron[i] = it->second;
+		}
+	}
+
+	void beginPattern(const int32_t& tId)
+	{
+		if (!m_pDataObjs[tId].m_patternOpen)
+		{
+			m_pDataObjs[tId].m_patternOpen = true;
+			std::memset(m_pDataObjs[tId].m_pAdded, 0, m_maxItemCnt);
+			std::memset(m_pDataObjs[tId].m_pAddedPerfExt, 0, m_maxItemCnt);
+			m_pDataObjs[tId].m_lastIDCnt = 0;
+			m_pDataObjs[tId].m_perfExtIDCnt = 0;
+#ifdef DEBUG
+			LOG_DEBUG << std::endl
+				<< std::endl
+				<< "--- BEGIN PATTERN ---" << std::endl;
+#endif
+		}
+	}
+
+	bool addPatternElement(const int32_t& tId, const ItemID& item, const Support& supp)
+	{
+		if (supp < m_pDataObjs[tId].m_minSupport) return true;
+		if (!m_pDataObjs[tId].m_patternOpen) return true;
+
+		if (!m_pDataObjs[tId].m_pAddedPerfExt[item] && !m_pDataObjs[tId].m_pAdded[item])
+		{
+#ifdef DEBUG
+			LOG_DEBUG << "itemID=" << item << "; item=" << (char)m_pId2Item[item] << "; supp=" << supp << std::endl;
+#endif
+			if (m_pClosedDetect->Add(item, supp) > 0)
+			{
+				m_pDataObjs[tId].m_pAdded[item] = true;
+				m_pDataObjs[tId].m_pSupports[m_pDataObjs[tId].m_lastIDCnt] = supp;
+				m_pDataObjs[tId].m_pLastID[m_pDataObjs[tId].m_lastIDCnt++] = item;
+
+				if (m_pDataObjs[tId].m_lastIDCnt >= m_maxItemCnt) LOG_ERROR << "ERROR: lastIDCnt >= maxItemCnt" << std::endl;
+			}
+			else
+				return false;
+		}
+
+		return true;
+	}
+
+	void addPerfectExt(const int32_t& tId, const ItemID& item, const Support& supp)
+	{
+		if (supp < m_pDataObjs[tId].m_minSupport) return;
+		if (!m_pDataObjs[tId].m_patternOpen) return;
+
+		// Once the set exceeds zmax it is discarded anyway, the compressed and maximal
+		// targets require all perfect extensions for the expansion and the maximality
+		// (with a maximal duration the extensions are split into windows, requiring all of them)
+		if (m_target == Target::TA_ALL && m_maxPatternLen != 0 && !hasMaxDuration() && m_pDataObjs[tId].m_lastIDCnt + m_pDataObjs[tId].m_perfExtIDCnt > m_maxPatternLen) return;
+
+		// Extensions exceeding the maximal duration together with the set are skipped
+		if (hasMaxDuration())
+		{
+			ItemC lo, hi;
+			lagRange(tId, false, lo, hi);
+			if (!fitsDuration(lo, hi, item)) return;
+		}
+
+		if (!m_pDataObjs[tId].m_pAddedPerfExt[item] && !m_pDataObjs[tId].m_pAdded[item])
+		{
+			m_pDataObjs[tId].m_pAddedPerfExt[item] = true;
+			m_pDataObjs[tId].m_pPerfExtIDs[m_pDataObjs[tId].m_perfExtIDCnt++] = item;
+		}
+	}
+
+	void pp(Pattern& results, const ItemID* pIDs, const std::size_t& size, const std::size_t& pos, const std::size_t& minLen, PatternType* pBase, std::size_t basePos, const Support& supp, const ItemC* pId2Item, const Support& maxSupport, const std::size_t& minNeuronCount, const ItemC& winLen)
+	{
+		pBase[basePos++] = m_pId2Item[pIDs[pos]];
+		for (std::size_t i = pos + 1; i < size; i++)
+			pp(results, pIDs, size, i, minLen, pBase, basePos, supp, pId2Item, maxSupport, minNeuronCount, winLen);
+
+		if (basePos >= minLen)
+			results.AddPattern(basePos, supp, pBase, pId2Item, maxSupport, minNeuronCount, winLen);
+	}
+
+	// Adds the current set extended by the given perfect extensions
+	void addLocalPattern(const int32_t& tId, const int64_t& pId, const ItemID* pExt, const std::size_t& extCnt)
+	{
+		size_t combLength = m_pDataObjs[tId].m_lastIDCnt + extCnt;
+		// A compressed pattern is kept as long as one of its expansions has a valid length
+		size_t maxCheckLength = (m_target == Target::TA_COMPRESSED) ? m_pDataObjs[tId].m_lastIDCnt : combLength;
+		if (combLength >= m_minPatternLen && (m_maxPatternLen == 0 || maxCheckLength <= m_maxPatternLen))
+		{
+			Support s = m_pDataObjs[tId].m_pSupports[m_pDataObjs[tId].m_lastIDCnt - 1];
+#ifdef ALL_PATTERN
+			for (std::size_t i = 0; i < m_pDataObjs[tId].m_lastIDCnt; i++)
+				m_pDataObjs[tId].m_pPatternBase[i] = m_pDataObjs[tId].m_pLastID[i] | (static_cast<ItemID>(m_pDataObjs[tId].m_pSupports[i]) << 32);
+
+#ifdef PERF_EXT_EXPANSION
+			// TODO: Add maxPatternLength
+			for (std::size_t i = 0; i < extCnt; i++)
+				pp(m_pPattern[pId], pExt, extCnt, i, m_minPatternLen, m_pDataObjs[tId].m_pPatternBase, static_cast<ItemC>(m_pDataObjs[tId].m_lastIDCnt), s, GetId2Item(), m_maxSupport, m_minNeuronCount, m_winLen);
+
+			if (m_pDataObjs[tId].m_lastIDCnt >= m_minPatternLen && (m_maxPatternLen == 0 || m_pDataObjs[tId].m_lastIDCnt <= m_maxPatternLen))
+				m_pPattern[pId].AddPattern(static_cast<ItemC>(m_pDataObjs[tId].m_lastIDCnt), s, m_pDataObjs[tId].m_pPatternBase, GetId2Item(), m_maxSupport, m_minNeuronCount, m_winLen);
 
 #else
-				for (std::size_t i = m_pDataObjs[tId].m_lastIDCnt; i < m_pDataObjs[tId].m_lastIDCnt + m_pDataObjs[tId].m_perfExtIDCnt; i++)
-					m_pDataObjs[tId].m_pPatternBase[i] = m_pDataObjs[tId].m_pPerfExtIDs[i - m_pDataObjs[tId].m_lastIDCnt] | (static_cast<ItemID>(0) << 32);
-				m_pPattern[pId].AddPattern(static_cast<ItemC>(m_pDataObjs[tId].m_lastIDCnt + m_pDataObjs[tId].m_perfExtIDCnt), s, m_pDataObjs[tId].m_pPatternBase, GetId2Item(), static_cast<Support>(m_maxSupport), static_cast<std::size_t>(m_minNeuronCount), m_winLen);
+			for (std::size_t i = m_pDataObjs[tId].m_lastIDCnt; i < m_pDataObjs[tId].m_lastIDCnt + extCnt; i++)
+				m_pDataObjs[tId].m_pPatternBase[i] = pExt[i - m_pDataObjs[tId].m_lastIDCnt] | (static_cast<ItemID>(0) << 32);
+			m_pPattern[pId].AddPattern(static_cast<ItemC>(m_pDataObjs[tId].m_lastIDCnt + extCnt), s, m_pDataObjs[tId].m_pPatternBase, GetId2Item(), static_cast<Support>(m_maxSupport), static_cast<std::size_t>(m_minNeuronCount), m_winLen);
 #endif
 #else // Only extract closed pattern
-				Support r = m_pClosedDetect->GetSupport();
+			Support r = m_pClosedDetect->GetSupport();
 
 #ifdef DEBUG
-				LOG_DEBUG << "s=" << s << "; r=" << r << std::endl;
+			LOG_DEBUG << "s=" << s << "; r=" << r << std::endl;
 #endif
-				if (r < s)
-				{
-					int32_t k = static_cast<int32_t>(m_pDataObjs[tId].m_lastIDCnt + m_pDataObjs[tId].m_perfExtIDCnt);
+			if (r < s)
+			{
+				int32_t k = static_cast<int32_t>(m_pDataObjs[tId].m_lastIDCnt + extCnt);
 
-					for (std::size_t i = 0; i < m_pDataObjs[tId].m_lastIDCnt; i++)
-						m_pDataObjs[tId].m_pPatternBase[i] = m_pId2Item[m_pDataObjs[tId].m_pLastID[i]];
-					for (std::size_t i = m_pDataObjs[tId].m_lastIDCnt; i < m_pDataObjs[tId].m_lastIDCnt + m_pDataObjs[tId].m_perfExtIDCnt; i++)
-						m_pDataObjs[tId].m_pPatternBase[i] = m_pId2Item[m_pDataObjs[tId].m_pPerfExtIDs[i - m_pDataObjs[tId].m_lastIDCnt]];
+				for (std::size_t i = 0; i < m_pDataObjs[tId].m_lastIDCnt; i++)
+					m_pDataObjs[tId].m_pPatternBase[i] = m_pId2Item[m_pDataObjs[tId].m_pLastID[i]];
+				for (std::size_t i = m_pDataObjs[tId].m_lastIDCnt; i < m_pDataObjs[tId].m_lastIDCnt + extCnt; i++)
+					m_pDataObjs[tId].m_pPatternBase[i] = m_pId2Item[pExt[i - m_pDataObjs[tId].m_lastIDCnt]];
 
-					std::memcpy(m_pDataObjs[tId].m_pCMem, m_pDataObjs[tId].m_pLastID, m_pDataObjs[tId].m_lastIDCnt * sizeof(ItemID));
-					std::memcpy(m_pDataObjs[tId].m_pCMem + m_pDataObjs[tId].m_lastIDCnt, m_pDataObjs[tId].m_pPerfExtIDs, m_pDataObjs[tId].m_perfExtIDCnt * sizeof(ItemID));
+				std::memcpy(m_pDataObjs[tId].m_pCMem, m_pDataObjs[tId].m_pLastID, m_pDataObjs[tId].m_lastIDCnt * sizeof(ItemID));
+				std::memcpy(m_pDataObjs[tId].m_pCMem + m_pDataObjs[tId].m_lastIDCnt, pExt, extCnt * sizeof(ItemID));
 #ifdef DEBUG
-					for (std::size_t i = 0; i < m_pDataObjs[id].m_lastIDCnt + m_pDataObjs[id].m_perfExtIDCnt; i++)
-						LOG_DEBUG << m_pDataObjs[id].m_pCMem[i] << " ";
-					LOG_DEBUG << std::endl;
+				for (std::size_t i = 0; i < m_pDataObjs[id].m_lastIDCnt + m_pDataObjs[id].m_perfExtIDCnt; i++)
+					LOG_DEBUG << m_pDataObjs[id].m_pCMem[i] << " ";
+				LOG_DEBUG << std::endl;
 #endif
 
-					m_pClosedDetect->Update(m_pDataObjs[tId].m_pCMem, k, s);
-					m_pPattern[pId].AddPattern(static_cast<ItemC>(m_pDataObjs[tId].m_lastIDCnt + m_pDataObjs[tId].m_perfExtIDCnt), s, m_pDataObjs[tId].m_pPatternBase, GetId2Item(), static_cast<Support>(m_maxSupport), static_cast<std::size_t>(m_minNeuronCount), m_winLen);
+				m_pClosedDetect->Update(m_pDataObjs[tId].m_pCMem, k, s);
+				m_pPattern[pId].AddPattern(static_cast<ItemC>(m_pDataObjs[tId].m_lastIDCnt + extCnt), s, m_pDataObjs[tId].m_pPatternBase, GetId2Item(), static_cast<Support>(m_maxSupport), static_cast<std::size_t>(m_minNeuronCount), m_winLen);
 #ifdef DEBUG
-					LOG_DEBUG << std::endl
-						<< std::endl;
-#endif
-				}
+				LOG_DEBUG << std::endl
+					<< std::endl;
 #endif
 			}
+#endif
+		}
+	}
+
+	void endLocalPattern(const int32_t& tId, const int64_t& pId, const ItemID& item)
+	{
+		UNUSED(item);
+		if (m_pDataObjs[tId].m_patternOpen)
+		{
+			// Maximal itemsets are added by addMaximal and filtered after the growth
+			if (m_target != Target::TA_MAXIMAL)
+				forEachExtWindow(tId, [&](const ItemID* pExt, const std::size_t& extCnt) { addLocalPattern(tId, pId, pExt, extCnt); });
 
 #ifndef ALL_PATTERN
 			m_pClosedDetect->Remove(1);
@@ -560,33 +1361,83 @@ private:
 		int64_t inc = 1;
 		bool error = false;
 
+		Timer budgetTimer;
+		budgetTimer.Start();
+		m_budgetExceeded = false;
+		m_completed.assign(pTree->cnt, 0);
+
 #ifdef USE_MPI
 		const int64_t iterationsPerProc = static_cast<int64_t>(pTree->cnt / procs);
 		start = rank;
 		inc = procs;
 #endif
 
-#ifdef USE_OPENMP
-#pragma omp parallel for schedule(dynamic)
-#endif
+		// The closed filter requires the buckets in descending order, therefore, process the
+		// items in this order when the buckets are consumed while the growth is running or
+		// when the growth may stop early (the finished buckets contain all supersets)
 #ifdef ALL_PATTERN
-		for (int64_t i = start; i < end; i += inc)
+		const bool descending = m_pipelined || hasBudget();
 #else
-		for (int64_t i = end - 1; i >= start; i -= inc)
+		const bool descending = true;
 #endif
-		{
-#ifdef _MSC_VER
-			if (error) continue;
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
 #endif
+		for (int64_t k = start; k < end; k += inc)
+		{
+			if (error || m_bucketAbort) continue;
+
+			const int64_t i = descending ? (end - 1 - k) : k;
 #ifdef USE_OPENMP
 			int32_t tId = omp_get_thread_num();
 #else
 			int32_t tId = 0;
 #endif
+			// Items outside of the mined subset (e.g., the sample of an estimation) or restored from a checkpoint
+			if (!m_itemMask.empty() && m_itemMask[i] != ITEM_MINE)
+			{
+				m_completed[i] = (m_itemMask[i] == ITEM_RESTORED);
+				finishBucket(i);
+				continue;
+			}
+
+			// Once the budget is exceeded no further items are started
+			if (hasBudget() && (m_budgetExceeded || exceedsBudget(budgetTimer)))
+			{
+				m_budgetExceeded = true;
+				finishBucket(i);
+				continue;
+			}
+
+			// A started item is always finished, an error discards the whole growth
+			m_completed[i] = 1;
+
+			Timer bucketTimer;
+			bucketTimer.Start();
+			const std::size_t nodesInUse = m_pThreadMem[tId].GetInUse();
+
 			FPHead* pH = pTree->pHeads + i;
+			bool extended = false;
+
+			// A raised support only applies to the following top-level items, every bucket is
+			// mined with a single support, i.e., it contains the same sets as a run with this support
+			m_pDataObjs[tId].m_minSupport = GetMinSupport();
+
+			// Items of the tree that are not frequent for a query with a higher support
+			if (pH->support < m_pDataObjs[tId].m_minSupport)
+			{
+				completeBucket(i);
+				continue;
+			}
+
 			beginPattern(tId);
+			if (m_target == Target::TA_MAXIMAL) m_pDataObjs[tId].m_maximal.Clear();
 			if (!addPatternElement(tId, pH->item, pH->support))
+			{
+				completeBucket(i);
 				continue;
+			}
 
 			FPNode* pNode = pH->list;
 			if (pNode && !pNode->succ)
@@ -594,53 +1445,53 @@ private:
 				for (FPNode* pAnc = pNode->parent; pAnc->id != IDX_MAX; pAnc = pAnc->parent)
 					addPerfectExt(tId, pTree->pHeads[pAnc->id].item, pTree->pHeads[pAnc->id].support);
 			}
-			else if (ppDst[tId])
+			else if (ppDst[tId] && canExtend(tId))
 			{
 				if (project(tId, ppDst[tId], pTree, static_cast<std::size_t>(i)))
 				{
+					extended = true;
 					// Use boolean return because throwing exceptions
 					// in a multi-threaded setup results in forceful
 					// termination of the application
-					if (!growth(tId, i, ppDst[tId]))
-					{
+					if (!growConditional(tId, i, ppDst[tId]))
 						error = true;
-#ifndef _MSC_VER
-						i = end;
-#endif
-					}
 				}
 			}
 
 			if (!error)
 			{
+				if (m_target == Target::TA_MAXIMAL && !extended)
+					addLeafMaximal(tId, i, pH->support);
+
 				endLocalPattern(tId, i, pH->item);
 
 				EndPattern(tId, pH->item);
 
+				bucketTimer.Stop();
+				if (!m_bucketStats.empty())
+					m_bucketStats[i] = { bucketTimer.GetElapsedTimeInSec(), m_pThreadMem[tId].GetInUse() - nodesInUse };
+
+				completeBucket(i);
+
 #ifdef USE_MPI
-				if (rank == ROOT_RANK)
-				{
-#endif
-#ifdef ALL_PATTERN
-					if (tId == 0)
-						LOG_INFO << "\r" << i + 1 << " / " << pTree->cnt << " Done" << std::flush;
-#else
-					if (tId == 0)
-						LOG_INFO << "\r" << pTree->cnt - i << " / " << pTree->cnt << " Done" << std::flush;
+				if (rank == ROOT_RANK)
+				{
 #endif
+					if (tId == 0)
+						LOG_INFO << "\r" << k + 1 << " / " << pTree->cnt << " Done" << std::flush;
 #ifdef USE_MPI
 				}
 #endif
 			}
 		}
 
-		if (error) throw(FPGException("Ctrl-C Interrupt"));
-
 		for (int32_t i = 0; i < m_objs; i++)
 			if (ppDst[i]) delete ppDst[i];
 
 		delete[] ppDst;
 
+		if (error) throw(FPGException("Ctrl-C Interrupt"));
+
 #ifdef USE_MPI
 		if (rank == ROOT_RANK)
 #endif
@@ -696,110 +1547,578 @@ private:
 		}
 		MPI_Finalize();
 
-		return rank == ROOT_RANK;
-#endif
+		return rank == ROOT_RANK;
+#endif
+
+		return true;
+	}
+
+	bool growth(const int32_t& tId, const int64_t& pId, FPTree* pTree)
+	{
+		FPTree* pDst = nullptr;
+		FPHead* pH = nullptr;
+		FPNode* pNode = nullptr;
+		FPNode* pAnc = nullptr;
+
+#ifdef WITH_SIG_TERM
+		if (sigAborted()) return false; //throw(FPGException("CTRL-C abort"));
+#endif
+
+		if (isSinglePath(pTree))
+		{
+			growthSinglePath(tId, pId, pTree);
+			return true;
+		}
+
+		if (pTree->cnt > 1)
+		{
+			pDst = new FPTree(m_tree->cnt - 1, m_tree->pIdx2Id, m_tree->pId2Item, &m_pThreadMem[tId]);
+			pDst->root.id = IDX_MAX;
+			pDst->root.succ = nullptr;
+			pDst->root.parent = nullptr;
+		}
+
+		pTree->pMemory->PushState();
+
+		for (int64_t i = pTree->cnt - 1; i > -1; i--)
+		{
+			bool extended = false;
+			pH = pTree->pHeads + i;
+			if (!addPatternElement(tId, pH->item, pH->support))
+				continue;
+
+			pNode = pH->list;
+			if (pNode && !pNode->succ)
+			{
+				for (pAnc = pNode->parent; pAnc->id != IDX_MAX; pAnc = pAnc->parent)
+					addPerfectExt(tId, pTree->pHeads[pAnc->id].item, pTree->pHeads[pAnc->id].support);
+			}
+			else if (pDst && canExtend(tId))
+			{
+				if (project(tId, pDst, pTree, static_cast<std::size_t>(i)))
+				{
+					extended = true;
+					if (!growConditional(tId, pId, pDst))
+						return false;
+				}
+			}
+
+			// Without a frequent extension the set (including its perfect extensions) is a maximal candidate
+			if (m_target == Target::TA_MAXIMAL && !extended)
+				addLeafMaximal(tId, pId, pH->support);
+
+			endLocalPattern(tId, pId, pH->item);
+		}
+
+		pTree->pMemory->PopState();
+		if (pDst) delete pDst;
+		return true;
+	}
+
+	// zmax as depth bound: All sets below the current one are longer than zmax once the current
+	// set reaches it, except for the maximal target, where the longer sets decide the maximality
+	bool canExtend(const int32_t& tId) const
+	{
+		return m_target == Target::TA_MAXIMAL || m_maxPatternLen == 0 || m_pDataObjs[tId].m_lastIDCnt < m_maxPatternLen;
+	}
+
+	// Recursion into the conditional tree of the current set. For maximal itemsets the
+	// head union tail (the set extended by all items of the conditional tree) is checked
+	// first: If it is covered by a known maximal set or cannot pass the output filters
+	// the subtree is skipped, if the conditional tree is a single path it is the only
+	// maximal candidate of the subtree.
+	bool growConditional(const int32_t& tId, const int64_t& pId, FPTree* pTree)
+	{
+		if (m_target != Target::TA_MAXIMAL) return growth(tId, pId, pTree);
+
+		std::size_t n = collectSet(tId);
+		for (std::size_t i = 0; i < pTree->cnt; i++)
+			m_pDataObjs[tId].m_pMaxItems[n++] = pTree->pHeads[i].item;
+
+		// The filters only become easier to pass for supersets, hence, if the largest set of
+		// the subtree fails them, all its sets do (the support is checked for the leaves)
+		if (n < m_minPatternLen || !Pattern::Accept(n, 0, m_pDataObjs[tId].m_pMaxItems, m_pId2Item, m_maxSupport, m_minNeuronCount, m_winLen)) return true;
+
+		std::sort(m_pDataObjs[tId].m_pMaxItems, m_pDataObjs[tId].m_pMaxItems + n);
+		if (m_pDataObjs[tId].m_maximal.HasSuperset(m_pDataObjs[tId].m_pMaxItems, n)) return true;
+
+		// With a maximal duration the single path may contain items that do not fit together
+		if (isSinglePath(pTree) && (!hasMaxDuration() || Pattern::WithinDuration(n, m_pDataObjs[tId].m_pMaxItems, m_pId2Item, m_winLen, m_maxDuration)))
+		{
+			// The deepest node has the lowest support of the path
+			addMaximal(tId, pId, n, pTree->pHeads[pTree->cnt - 1].support);
+			return true;
+		}
+
+		return growth(tId, pId, pTree);
+	}
+
+	// In a single path every item has exactly one node, whose ancestors are all more frequent items
+	// of the path, i.e., its perfect extensions. Hence, the sets can be enumerated directly without
+	// allocating a tree for the next level or projecting any further.
+	void growthSinglePath(const int32_t& tId, const int64_t& pId, const FPTree* pTree)
+	{
+		for (int64_t i = pTree->cnt - 1; i > -1; i--)
+		{
+			const FPHead* pH = pTree->pHeads + i;
+			if (!addPatternElement(tId, pH->item, pH->support))
+				continue;
+
+			for (int64_t j = i - 1; j > -1; j--)
+				addPerfectExt(tId, pTree->pHeads[j].item, pTree->pHeads[j].support);
+
+			if (m_target == Target::TA_MAXIMAL)
+				addLeafMaximal(tId, pId, pH->support);
+
+			endLocalPattern(tId, pId, pH->item);
+		}
+	}
+
+	bool isSinglePath(const FPTree* pTree) const
+	{
+		for (std::size_t i = 0; i < pTree->cnt; i++)
+		{
+			const FPNode* pNode = pTree->pHeads[i].list;
+			if (!pNode || pNode->succ) return false;
+			if (pNode->parent != ((i == 0) ? &pTree->root : pTree->pHeads[i - 1].list)) return false;
+		}
+
+		return true;
+	}
+
+	// Copies the current set (including its perfect extensions) into the maximal buffer
+	std::size_t collectSet(const int32_t& tId)
+	{
+		return collectSet(tId, m_pDataObjs[tId].m_pPerfExtIDs, m_pDataObjs[tId].m_perfExtIDCnt);
+	}
+
+	std::size_t collectSet(const int32_t& tId, const ItemID* pExt, const std::size_t& extCnt)
+	{
+		DataObjs& d = m_pDataObjs[tId];
+		std::memcpy(d.m_pMaxItems, d.m_pLastID, d.m_lastIDCnt * sizeof(ItemID));
+		std::memcpy(d.m_pMaxItems + d.m_lastIDCnt, pExt, extCnt * sizeof(ItemID));
+		return d.m_lastIDCnt + extCnt;
+	}
+
+	// Adds the current set without frequent extension (one candidate per window of its perfect extensions)
+	void addLeafMaximal(const int32_t& tId, const int64_t& pId, const Support& supp)
+	{
+		forEachExtWindow(tId, [&](const ItemID* pExt, const std::size_t& extCnt) { addMaximal(tId, pId, collectSet(tId, pExt, extCnt), supp); });
+	}
+
+	// Adds the first n items of the maximal buffer to the bucket if they are not covered by a
+	// maximal set of the bucket. As all supersets of a set are generated before the set itself,
+	// the bucket only contains sets that are maximal among the sets of this top-level item.
+	// The output filters (except zmax) hold for all supersets of a set that passes them, thus,
+	// sets failing them are only kept for the pruning and never become part of the bucket.
+	void addMaximal(const int32_t& tId, const int64_t& pId, const std::size_t& n, const Support& supp)
+	{
+		DataObjs& d = m_pDataObjs[tId];
+		std::sort(d.m_pMaxItems, d.m_pMaxItems + n);
+
+		if (d.m_maximal.HasSuperset(d.m_pMaxItems, n)) return;
+
+		d.m_maximal.Add(d.m_pMaxItems, n);
+
+		if (n >= m_minPatternLen && Pattern::Accept(n, supp, d.m_pMaxItems, m_pId2Item, m_maxSupport, m_minNeuronCount, m_winLen))
+			m_pPattern[pId].AddPattern(n, supp, d.m_pMaxItems);
+	}
+
+	// Hands a mined bucket to the writer (if any) and to the consumer of a pipelined growth
+	void completeBucket(const int64_t& i)
+	{
+		if (m_bucketWriter) m_bucketWriter(static_cast<std::size_t>(i), m_pPattern[i]);
+		finishBucket(i);
+	}
+
+	bool hasBudget() const
+	{
+		return m_budgetTime > 0 || m_budgetMem > 0;
+	}
+
+	bool exceedsBudget(const Timer& timer) const
+	{
+		return (m_budgetTime > 0 && timer.GetElapsedTimeInSec() > m_budgetTime) || (m_budgetMem > 0 && GetCurrentRSS() > m_budgetMem);
+	}
+
+	void finishBucket(const int64_t& i)
+	{
+		if (!m_pipelined) return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_bucketMtx);
+			m_bucketDone[i] = true;
+		}
+
+		m_bucketCv.notify_all();
+	}
+
+	bool waitForBucket(const int64_t& i)
+	{
+		std::unique_lock<std::mutex> lock(m_bucketMtx);
+		m_bucketCv.wait(lock, [this, &i]() { return m_bucketDone[i] || m_bucketAbort; });
+		return !m_bucketAbort;
+	}
+
+	void abortBuckets()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_bucketMtx);
+			m_bucketAbort = true;
+		}
+
+		m_bucketCv.notify_all();
+	}
+
+	FrequencyMap getFrequency(const Transactions& transactions)
+	{
+		FrequencyMap frequency;
+		for (const Transaction& transaction : transactions)
+		{
+			for (const ItemC& item : transaction)
+				frequency[item]++;
+		}
+
+		return frequency;
+	}
+
+	bool reduceItems(Transactions& transactions, FrequencyMap& frequency)
+	{
+		bool reduced = false;
+		for (Transaction& trans : transactions)
+		{
+			for (Transaction::iterator it = std::begin(trans); it != std::end(trans); it++)
+			{
+				if (frequency[*it] < m_minSupport)
+				{
+					it = trans.erase(it);
+					if (it != std::begin(trans))
+						it--; // Decrement because erase returns the iterater after the deleted element which would be skipped due to the loop increment
+					reduced = true;
+
+					if (it == std::end(trans)) break;
+				}
+			}
+		}
+
+		map_erase_if(frequency, [&minSupport = m_minSupport](const std::pair<ItemC, uint64_t>& p) { return p.second < minSupport; });
+
+		return reduced;
+	}
+
+	// Every reported pattern has at least zmin items, a lag-0 item and min_neu distinct neurons, thus,
+	// transactions failing any of these do not support a reported pattern and only slow down the growth
+	// Every item of a set with k items forms a frequent pair with the k - 1 other items, hence, items
+	// with less than zmin - 1 frequent partners (excluding the removed items) cannot be part of a
+	// reported pattern. The pair supports are counted in a triangular matrix.
+	bool reducePairs(Transactions& transactions, const FrequencyMap& frequency)
+	{
+		if (m_minPatternLen < 3 || frequency.empty() || !PairMatrix::Fits(frequency.size())) return false;
+
+		// The items are neuron * winLen + lag, hence, a lookup table indexed by the item is small
+		const uint32_t n = static_cast<uint32_t>(frequency.size());
+		std::vector<uint32_t> idx(static_cast<std::size_t>(frequency.rbegin()->first) + 1, 0);
+		uint32_t cnt = 0;
+		for (const auto& [item, supp] : frequency)
+			idx[item] = cnt++;
+
+		std::vector<std::vector<uint32_t>> dense;
+		dense.reserve(transactions.size());
+		for (const Transaction& trans : transactions)
+		{
+			std::vector<uint32_t> t;
+			for (const ItemC& item : trans)
+				t.push_back(idx[item]);
+
+			std::sort(std::begin(t), std::end(t));
+			t.erase(std::unique(std::begin(t), std::end(t)), std::end(t));
+			dense.push_back(std::move(t));
+		}
+
+		PairMatrix pairs(n);
+		pairs.Count(dense);
+
+		std::vector<uint32_t> partners(n, 0);
+		for (uint32_t a = 1; a < n; a++)
+		{
+			for (uint32_t b = 0; b < a; b++)
+			{
+				if (pairs.Get(a, b) < m_minSupport) continue;
+				partners[a]++;
+				partners[b]++;
+			}
+		}
+
+		std::vector<bool> removed(n, false);
+		std::vector<uint32_t> queue;
+		for (uint32_t a = 0; a < n; a++)
+		{
+			if (partners[a] + 1 < m_minPatternLen)
+			{
+				removed[a] = true;
+				queue.push_back(a);
+			}
+		}
+
+		// Removing an item reduces the partners of all items it forms a frequent pair with
+		while (!queue.empty())
+		{
+			const uint32_t a = queue.back();
+			queue.pop_back();
+
+			for (uint32_t b = 0; b < n; b++)
+			{
+				if (b == a || removed[b] || pairs.Get(a, b) < m_minSupport) continue;
+				if (--partners[b] + 1 < m_minPatternLen)
+				{
+					removed[b] = true;
+					queue.push_back(b);
+				}
+			}
+		}
+
+		const std::size_t removedCnt = static_cast<std::size_t>(std::count(std::begin(removed), std::end(removed), true));
+		if (removedCnt == 0) return false;
+
+		for (Transaction& trans : transactions)
+			std::experimental::erase_if(trans, [&idx, &removed](const ItemC& item) { return removed[idx[item]]; });
+
+		LOG_VERBOSE << "Removed " << removedCnt << " items without zmin - 1 frequent partners ... " << std::flush;
+		return true;
+	}
+
+	// (Re-)Allocates the per thread objects for the given number of threads
+	void initThreads(const int32_t& threads)
+	{
+		delete[] m_pDataObjs;
+		delete[] m_pThreadMem;
+
+#ifdef USE_OPENMP
+		int32_t maxThreads = omp_get_num_threads();
+		if ((threads <= maxThreads && threads > 1))
+		{
+			LOG_INFO << "Limiting the number of threads to " << threads << std::endl;
+			omp_set_num_threads(threads);
+		}
+		else if (threads == 1 || threads == -1)
+		{
+			LOG_INFO << "Multi-threading disabled" << std::endl;
+			omp_set_num_threads(1);
+		}
+		else if (threads > maxThreads)
+			LOG_WARNING << "Set number of threads (" << threads << ") exceeds the maximal available number of threads (" << maxThreads << "), limiting to maximal number" << std::endl;
+
+		m_objs = omp_get_max_threads();
+		if (threads == 0 || threads > 1)
+			LOG_INFO << "Number of Threads: " << m_objs << std::endl;
+#else
+		UNUSED(threads);
+#endif
+
+		m_pDataObjs = new DataObjs[m_objs]();
+		m_pThreadMem = new FPNMemory[m_objs];
+
+		for (int32_t i = 0; i < m_objs; i++)
+		{
+			m_pDataObjs[i].Init(m_maxItemCnt);
+			m_pThreadMem[i].Init(65536);
+		}
+	}
+
+	// Lower bound of the size supports for all valid pattern lengths up to k (index k, the last entry applies to all
+	// larger sets). Unlike the supports themselves the bound is non-increasing, i.e., a set with a support below the
+	// bound of its size has no subset that passes the support of its own size either (required for closed sets).
+	static std::vector<Support> sizeBounds(const std::vector<Support>& sizeSupports, const uint32_t& minPatternLen, const uint32_t& maxPatternLen)
+	{
+		if (sizeSupports.empty()) return {};
+
+		const std::size_t last = (maxPatternLen != 0) ? maxPatternLen : std::max<std::size_t>(sizeSupports.size() - 1, minPatternLen);
+		std::vector<Support> bounds(last + 1, SUPP_MAX);
+
+		for (std::size_t k = minPatternLen; k <= last; k++)
+			bounds[k] = std::min((k > 0) ? bounds[k - 1] : SUPP_MAX, sizeSupports[std::min(k, sizeSupports.size() - 1)]);
+
+		return bounds;
+	}
+
+	void reduceTransactions(Transactions& transactions)
+	{
+		std::vector<ItemC> neurons;
+
+		std::experimental::erase_if(transactions, [this, &neurons](const Transaction& t) {
+			return !canSupportPattern(t, m_minPatternLen, m_minNeuronCount, neurons);
+		});
+	}
+
+	bool canSupportPattern(const Transaction& t, const uint32_t& minPatternLen, const uint32_t& minNeuronCount, std::vector<ItemC>& neurons) const
+	{
+		if (t.size() < minPatternLen) return false;
+		if (std::none_of(std::begin(t), std::end(t), [this](const ItemC& i) { return i % m_winLen == 0; })) return false;
+		if (minNeuronCount <= 1) return true;
+
+		neurons.clear();
+		for (const ItemC& i : t)
+			neurons.push_back(i / m_winLen);
 
-		return true;
+		std::sort(std::begin(neurons), std::end(neurons));
+		return static_cast<std::size_t>(std::distance(std::begin(neurons), std::unique(std::begin(neurons), std::end(neurons)))) >= minNeuronCount;
 	}
 
-	bool growth(const int32_t& tId, const int64_t& pId, FPTree* pTree)
+	// Extends the per item arrays and the tree by the given items (appended at the end of the order without support)
+	void addItems(const std::vector<ItemC>& items)
 	{
-		FPTree* pDst = nullptr;
-		FPHead* pH = nullptr;
-		FPNode* pNode = nullptr;
-		FPNode* pAnc = nullptr;
+		const std::size_t cnt = m_maxItemCnt + items.size();
 
-#ifdef WITH_SIG_TERM
-		if (sigAborted()) return false; //throw(FPGException("CTRL-C abort"));
-#endif
+		uint32_t* pIdx2Id = new uint32_t[cnt]();
+		ItemC* pId2Item   = new ItemC[cnt]();
+		FPHead* pHeads    = new FPHead[cnt];
 
-		if (pTree->cnt > 1)
+		std::memcpy(pIdx2Id, m_pIdx2Id, m_maxItemCnt * sizeof(uint32_t));
+		std::memcpy(pId2Item, m_pId2Item, m_maxItemCnt * sizeof(ItemC));
+		std::copy(m_tree->pHeads, m_tree->pHeads + m_maxItemCnt, pHeads);
+
+		for (std::size_t id = m_maxItemCnt; id < cnt; id++)
 		{
-			pDst = new FPTree(m_tree->cnt - 1, m_tree->pIdx2Id, m_tree->pId2Item, &m_pThreadMem[tId]);
-			pDst->root.id = IDX_MAX;
-			pDst->root.succ = nullptr;
-			pDst->root.parent = nullptr;
+			pIdx2Id[id]         = static_cast<uint32_t>(id);
+			pId2Item[id]        = items[id - m_maxItemCnt];
+			pHeads[id].item     = id;
+			pHeads[id].support  = 0;
+			pHeads[id].list     = nullptr;
+			pHeads[id].pMemory  = &m_memory;
 		}
 
-		pTree->pMemory->PushState();
-
-		for (int64_t i = pTree->cnt - 1; i > -1; i--)
-		{
-			pH = pTree->pHeads + i;
-			if (!addPatternElement(tId, pH->item, pH->support))
-				continue;
+		delete[] m_pIdx2Id;
+		delete[] m_pId2Item;
+		delete[] m_tree->pHeads;
+		delete[] m_pId2Neuron;
+		delete[] m_pPattern;
+		delete m_pClosedDetect;
 
-			pNode = pH->list;
-			if (pNode && !pNode->succ)
-			{
-				for (pAnc = pNode->parent; pAnc->id != IDX_MAX; pAnc = pAnc->parent)
-					addPerfectExt(tId, pTree->pHeads[pAnc->id].item, pTree->pHeads[pAnc->id].support);
-			}
-			else if (pDst)
-			{
-				if (project(tId, pDst, pTree, static_cast<std::size_t>(i)))
-				{
-					if (!growth(tId, pId, pDst))
-						return false;
-				}
-			}
+		m_pIdx2Id          = pIdx2Id;
+		m_pId2Item         = pId2Item;
+		m_tree->pHeads     = pHeads;
+		m_tree->pIdx2Id    = m_pIdx2Id;
+		m_tree->pId2Item   = m_pId2Item;
+		m_tree->cnt        = cnt;
+		m_maxItemCnt       = cnt;
+		m_pId2Neuron       = new uint32_t[cnt]();
+		m_pPattern         = new Pattern[cnt];
+		m_pClosedDetect    = new ClosedDetect(cnt);
 
-			endLocalPattern(tId, pId, pH->item);
-		}
+		delete[] m_pDataObjs;
+		m_pDataObjs = new DataObjs[m_objs]();
+		for (int32_t i = 0; i < m_objs; i++)
+			m_pDataObjs[i].Init(m_maxItemCnt);
 
-		pTree->pMemory->PopState();
-		if (pDst) delete pDst;
-		return true;
+		initNeurons();
 	}
 
-	FrequencyMap getFrequency(const Transactions& transactions)
+	// The order of the items only affects the size of the tree, not the result. It is repaired once
+	// a (frequent) item became considerably more frequent than an item before it.
+	bool rankDrifted() const
 	{
-		FrequencyMap frequency;
-		for (const Transaction& transaction : transactions)
+		Support lo = SUPP_MAX;
+
+		for (std::size_t id = 0; id < m_tree->cnt; id++)
 		{
-			for (const ItemC& item : transaction)
-				frequency[item]++;
+			const Support& supp = m_tree->pHeads[id].support;
+			if (supp < m_build.minSupport) continue;
+			if (lo != SUPP_MAX && supp > lo + lo / 4) return true;
+			lo = std::min(lo, supp);
 		}
 
-		return frequency;
+		return false;
 	}
 
-	bool reduceItems(Transactions& transactions, FrequencyMap& frequency)
+	// Rebuilds the tree in descending order of the current item supports. The tree itself is the
+	// compressed database, every node represents its support minus the ones of its children.
+	void rerank()
 	{
-		bool reduced = false;
-		for (Transaction& trans : transactions)
+		const std::size_t cnt = m_tree->cnt;
+		std::vector<std::size_t> order(cnt);
+		std::vector<std::size_t> rank(cnt);
+
+		for (std::size_t id = 0; id < cnt; id++)
+			order[id] = id;
+
+		std::sort(std::begin(order), std::end(order), [this](const std::size_t& a, const std::size_t& b) {
+			if (m_tree->pHeads[a].support != m_tree->pHeads[b].support) return m_tree->pHeads[a].support > m_tree->pHeads[b].support;
+			return m_pId2Item[a] > m_pId2Item[b];
+		});
+
+		for (std::size_t r = 0; r < cnt; r++)
+			rank[order[r]] = r;
+
+		// The children have higher ids than their parent, hence, in ascending order every node still
+		// has its full support when it is subtracted from its parent (the tree is rebuilt anyway)
+		for (std::size_t id = 0; id < cnt; id++)
 		{
-			for (Transaction::iterator it = std::begin(trans); it != std::end(trans); it++)
+			for (FPNode* pNode = m_tree->pHeads[id].list; pNode; pNode = pNode->succ)
+				pNode->parent->support -= pNode->support;
+		}
+
+		std::vector<std::size_t> data;
+		std::vector<std::size_t> offsets(1, 0);
+		std::vector<Support> supports;
+
+		for (std::size_t id = 0; id < cnt; id++)
+		{
+			for (const FPNode* pNode = m_tree->pHeads[id].list; pNode; pNode = pNode->succ)
 			{
-				if (frequency[*it] < m_minSupport)
-				{
-					it = trans.erase(it);
-					if (it != std::begin(trans))
-						it--; // Decrement because erase returns the iterater after the deleted element which would be skipped due to the loop increment
-					reduced = true;
+				const Support supp = pNode->support;
+				if (supp == 0) continue;
 
-					if (it == std::end(trans)) break;
-				}
+				for (const FPNode* pAnc = pNode; pAnc->id != IDX_MAX; pAnc = pAnc->parent)
+					data.push_back(rank[pAnc->id]);
+
+				std::sort(std::begin(data) + offsets.back(), std::end(data));
+				offsets.push_back(data.size());
+				supports.push_back(supp);
 			}
 		}
 
-		map_erase_if(frequency, [&minSupport = m_minSupport](const std::pair<ItemC, uint64_t>& p) { return p.second < minSupport; });
+		// Inserting the paths in lexicographic order lets the tree share their common prefixes
+		std::vector<std::size_t> paths(supports.size());
+		for (std::size_t i = 0; i < paths.size(); i++)
+			paths[i] = i;
 
-		return reduced;
-	}
+		std::sort(std::begin(paths), std::end(paths), [&data, &offsets](const std::size_t& a, const std::size_t& b) {
+			return std::lexicographical_compare(std::begin(data) + offsets[a], std::begin(data) + offsets[a + 1], std::begin(data) + offsets[b], std::begin(data) + offsets[b + 1]);
+		});
 
-	void reduceTransactions(Transactions& transactions)
-	{
-		std::experimental::erase_if(transactions, [&minPatternLen = m_minPatternLen](const Transaction& t) { return t.size() < minPatternLen; });
+		std::vector<FPHead> heads(m_tree->pHeads, m_tree->pHeads + cnt);
+		std::vector<ItemC> id2Item(m_pId2Item, m_pId2Item + cnt);
+
+		for (std::size_t id = 0; id < cnt; id++)
+		{
+			m_pId2Item[rank[id]]                = id2Item[id];
+			m_tree->pHeads[rank[id]].support    = heads[id].support;
+			m_tree->pHeads[rank[id]].item       = rank[id];
+			m_tree->pHeads[rank[id]].list       = nullptr;
+		}
+
+		m_memory.Clear();
+		m_tree->root.support = 0;
+
+		for (const std::size_t& p : paths)
+			m_tree->Add(data.data() + offsets[p], offsets[p + 1] - offsets[p], supports[p]);
+
+		initNeurons();
 	}
 
 private:
-	Support m_minSupport;
+	std::atomic<Support> m_minSupport; // Can be raised while the growth is running (RaiseMinSupport)
 	uint32_t m_minPatternLen;
 	uint32_t m_maxPatternLen;
 	ItemC m_winLen;
 	uint32_t m_maxSupport;
 	uint32_t m_minNeuronCount;
+	Target m_target;
+	uint32_t m_maxDuration;
+	std::vector<Support> m_sizeSupports;
+	std::vector<Support> m_sizeBounds;
+	Job m_build;
+	FrequencyMap m_pruned;
 	FPTree* m_tree;
 	std::size_t m_maxItemCnt;
 	int32_t m_objs;
@@ -821,6 +2140,14 @@ private:
 
 		bool m_patternOpen;
 		PatternType* m_pPatternBase;
+
+		MaximalIndex m_maximal;
+		ItemID* m_pMaxItems;
+
+		uint32_t* m_pNeuronMark;
+		uint32_t m_neuronStamp;
+		ItemID* m_pWindowIDs;
+		Support m_minSupport; // Minimum support of the current top-level item, see RaiseMinSupport
 #ifndef ALL_PATTERN
 		ItemID* m_pCMem;
 #endif
@@ -835,7 +2162,13 @@ private:
 			m_lastIDCnt(0),
 			m_perfExtIDCnt(0),
 			m_patternOpen(false),
-			m_pPatternBase(nullptr)
+			m_pPatternBase(nullptr),
+			m_maximal(),
+			m_pMaxItems(nullptr),
+			m_pNeuronMark(nullptr),
+			m_neuronStamp(0),
+			m_pWindowIDs(nullptr),
+			m_minSupport(0)
 #ifndef ALL_PATTERN
 			,
 			m_pCMem(nullptr)
@@ -852,6 +2185,9 @@ private:
 			delete[] m_pPerfExtIDs;
 			delete[] m_pSupports;
 			delete[] m_pPatternBase;
+			delete[] m_pMaxItems;
+			delete[] m_pNeuronMark;
+			delete[] m_pWindowIDs;
 #ifndef ALL_PATTERN
 			delete[] m_pCMem;
 #endif
@@ -869,6 +2205,9 @@ private:
 			m_pSupports = new Support[elements]();
 
 			m_pPatternBase = new PatternType[elements]();
+			m_pMaxItems = new ItemID[elements]();
+			m_pNeuronMark = new uint32_t[elements]();
+			m_pWindowIDs = new ItemID[elements]();
 #ifndef ALL_PATTERN
 			m_pCMem = new ItemID[elements]();
 #endif
@@ -879,6 +2218,7 @@ private:
 
 	uint32_t* m_pIdx2Id;
 	ItemC* m_pId2Item;
+	uint32_t* m_pId2Neuron;
 
 	FPNMemory m_memory;
 	FPNMemory* m_pThreadMem;
@@ -886,6 +2226,26 @@ private:
 
 	ClosedDetect* m_pClosedDetect;
 	Timer m_initTime;
+
+	// Pipelined growth state
+	bool m_pipelined;
+	std::mutex m_bucketMtx;
+	std::condition_variable m_bucketCv;
+	std::vector<bool> m_bucketDone;
+	std::atomic<bool> m_bucketAbort;
+	std::size_t m_consumedCnt;
+
+	// State of the top-level items for the growth (all are mined if empty) and the cost of every item (not recorded if empty)
+	std::vector<uint8_t> m_itemMask;
+	std::vector<BucketStats> m_bucketStats;
+
+	// Anytime growth: limits of the growth (0 = no limit) and the top-level items of the last growth that were mined
+	double m_budgetTime;
+	uint64_t m_budgetMem;
+	std::atomic<bool> m_budgetExceeded;
+	std::vector<uint8_t> m_completed;
+
+	BucketWriter m_bucketWriter;
 };
 
 void PostProcessing(const Pattern* pPattern, const std::size_t& maxC, const std::size_t& itemCount, const std::size_t& minPatternLength, const PatternType& winLen, const ItemC* pId2Item, std::vector<const PatternType*>& res)
@@ -927,34 +2287,136 @@ void PostProcessing(const Pattern* pPattern, const std::size_t& maxC, const std:
 	LOG_INFO << "Reduction: " << cnt << " -> " << res.size() << std::endl;
 }
 
-void ClosedDetection(const FPGrowth& fp, const Pattern* pPattern, std::vector<PatternPair>& closed)
+// The k highest supports of the sets passed to the output (a min-heap, only used by the consumer thread of the
+// pipelined growth). Once k sets have been found the minimum support of the growth is raised to the k-th highest
+// support, as the closed sets only depend on the supersets with the same support the remaining sets stay exact.
+class TopKSupport
 {
-	const std::size_t itemCount = fp.GetItemCount();
-	const ItemC* pId2Item = fp.GetId2Item();
-	if (fp.GetPatternCount() == 0)
+	DISABLE_COPY_ASSIGN_MOVE(TopKSupport)
+
+public:
+	TopKSupport(FPGrowth& fp, const std::size_t& k) :
+		m_fp(fp),
+		m_k(k),
+		m_heap()
+	{}
+
+	void Add(const Support& supp)
 	{
-		LOG_INFO_EVAL << "No itemsets provided, skipping Closed Detection" << std::endl;
-		return;
+		if (m_heap.size() < m_k)
+			m_heap.push(supp);
+		else if (supp > m_heap.top())
+		{
+			m_heap.pop();
+			m_heap.push(supp);
+		}
+		else
+			return;
+
+		if (m_heap.size() == m_k)
+			m_fp.RaiseMinSupport(m_heap.top());
 	}
 
-	Timer timer;
+	// Minimum support of the top-k sets (including the ones with the same support as the k-th set), 0 if there are less than k sets
+	Support GetThreshold() const
+	{
+		return (m_heap.size() == m_k) ? m_heap.top() : 0;
+	}
 
-	LOG_INFO_EVAL << "Closed Detection ... " << std::flush;
+private:
+	FPGrowth& m_fp;
+	std::size_t m_k;
+	std::priority_queue<Support, std::vector<Support>, std::greater<Support>> m_heap;
+};
 
-	timer.Start();
+// Destination of the closed and maximal filters, either the sets themselves (as items) or only their counts in a pattern spectrum
+class PatternOutput
+{
+public:
+	PatternOutput(std::vector<PatternPair>& sets, TopKSupport* pTopK = nullptr) :
+		m_pSets(&sets),
+		m_pSpectrum(nullptr),
+		m_pTopK(pTopK)
+	{}
+
+	PatternOutput(PatternSpectrum& spectrum) :
+		m_pSets(nullptr),
+		m_pSpectrum(&spectrum),
+		m_pTopK(nullptr)
+	{}
+
+	PatternOutput(const PatternOutput&) = default;
+	PatternOutput& operator=(const PatternOutput&) = default;
+
+	// Adds a set given by the ids of its items (the upper 32 bit are ignored)
+	void Add(const PatternType* pIds, const std::size_t& len, const Support& supp, const ItemC* pId2Item) const
+	{
+		if (m_pTopK) m_pTopK->Add(supp);
+
+		if (m_pSpectrum)
+		{
+			m_pSpectrum->Add(len, supp, [&pIds, &pId2Item](const std::size_t& i) { return pId2Item[pIds[i] & 0xFFFFFFFF]; });
+			return;
+		}
 
-	ClosedDetect cd(itemCount);
-	PatternType* pM = new PatternType[itemCount];
-	PatternType* pPfExt = new PatternType[itemCount];
-	PatternType* pItems = new PatternType[itemCount];
-	bool* pAdded = new bool[itemCount]();
+		PatternPair ppN;
+		ppN.first.reserve(len);
+		ppN.second = supp;
 
-	ItemID base = ITEM_ID_MAX;
-	int32_t k = 0;
+		for (std::size_t i = 0; i < len; i++)
+			ppN.first.push_back(static_cast<PatternType>(pId2Item[pIds[i] & 0xFFFFFFFF]));
 
-	for (int64_t patI = itemCount - 1; patI > -1; patI--)
+		m_pSets->push_back(std::move(ppN));
+	}
+
+	std::size_t GetCount() const
+	{
+		return m_pSets ? m_pSets->size() : m_pSpectrum->GetCount();
+	}
+
+private:
+	std::vector<PatternPair>* m_pSets;
+	PatternSpectrum* m_pSpectrum;
+	TopKSupport* m_pTopK;
+};
+
+// Closed detection on the buckets generated by the growth, the buckets have
+// to be processed in descending order (i.e., the order of the ClosedDetect)
+template<typename Detect = ClosedDetect>
+class ClosedFilter
+{
+	DISABLE_COPY_ASSIGN_MOVE(ClosedFilter)
+
+public:
+	ClosedFilter(const FPGrowth& fp, const PatternOutput& closed) :
+		m_itemCount(fp.GetItemCount()),
+		m_pId2Item(fp.GetId2Item()),
+		m_closed(closed),
+		m_cd(fp.GetItemCount()),
+		m_pM(nullptr),
+		m_pPfExt(nullptr),
+		m_pItems(nullptr),
+		m_pAdded(nullptr),
+		m_base(ITEM_ID_MAX),
+		m_k(0)
+	{
+		m_pM     = new PatternType[m_itemCount];
+		m_pPfExt = new PatternType[m_itemCount];
+		m_pItems = new PatternType[m_itemCount];
+		m_pAdded = new bool[m_itemCount]();
+	}
+
+	~ClosedFilter()
+	{
+		delete[] m_pM;
+		delete[] m_pPfExt;
+		delete[] m_pItems;
+		delete[] m_pAdded;
+	}
+
+	void Process(const Pattern& pattern)
 	{
-		for (const PatternType* pp : pPattern[patI])
+		for (const PatternType* pp : pattern)
 		{
 #ifdef WITH_SIG_TERM
 			if (sigAborted()) throw(FPGException("CTRL-C abort"));
@@ -962,29 +2424,29 @@ void ClosedDetection(const FPGrowth& fp, const Pattern* pPattern, std::vector<Pa
 			int32_t pfExtCnt = 0;
 			bool skip = false;
 
-			if (base != pp[Pattern::DATA_IDX])
+			if (m_base != pp[Pattern::DATA_IDX])
 			{
-				cd.Remove(k);
-				base = pp[Pattern::DATA_IDX];
-				std::memset(pAdded, 0, itemCount * sizeof(bool));
-				k = 0;
+				m_cd.Remove(m_k);
+				m_base = pp[Pattern::DATA_IDX];
+				std::memset(m_pAdded, 0, m_itemCount * sizeof(bool));
+				m_k = 0;
 			}
 
-			for (int32_t i = 0; i < k; i++)
+			for (int32_t i = 0; i < m_k; i++)
 			{
 #ifdef WITH_SIG_TERM
 				if (sigAborted()) throw(FPGException("CTRL-C abort"));
 #endif
 				// TODO: Probably can start at 1 here
-				if (pItems[i] != (pp[Pattern::DATA_IDX + i] & 0xFFFFFFFF))
+				if (m_pItems[i] != (pp[Pattern::DATA_IDX + i] & 0xFFFFFFFF))
 				{
-					for (int32_t j = i; j < k; j++)
+					for (int32_t j = i; j < m_k; j++)
 					{
-						pAdded[pItems[j]] = false;
-						cd.Remove(1);
+						m_pAdded[m_pItems[j]] = false;
+						m_cd.Remove(1);
 					}
 
-					k = i;
+					m_k = i;
 					break;
 				}
 			}
@@ -998,13 +2460,13 @@ void ClosedDetection(const FPGrowth& fp, const Pattern* pPattern, std::vector<Pa
 				Support supp = i >> 32;
 				ItemID item = i & 0xFFFFFFFF;
 				if (supp == 0)
-					pPfExt[pfExtCnt++] = item;
-				else if (!pAdded[item])
+					m_pPfExt[pfExtCnt++] = item;
+				else if (!m_pAdded[item])
 				{
-					if (cd.Add2(item, supp) > 0)
+					if (m_cd.Add2(item, supp) > 0)
 					{
-						pItems[k++] = item;
-						pAdded[item] = true;
+						m_pItems[m_k++] = item;
+						m_pAdded[item] = true;
 					}
 					else
 					{
@@ -1017,37 +2479,26 @@ void ClosedDetection(const FPGrowth& fp, const Pattern* pPattern, std::vector<Pa
 			if (skip) continue;
 
 			Support s = static_cast<Support>(pp[Pattern::SUPP_IDX]);
-			Support r = cd.GetSupport();
+			Support r = m_cd.GetSupport();
 
-			if (static_cast<std::size_t>(k) + pfExtCnt == pp[Pattern::LEN_IDX])
+			if (static_cast<std::size_t>(m_k) + pfExtCnt == pp[Pattern::LEN_IDX])
 			{
 #ifdef DEBUG
 				LOG_DEBUG << "s=" << s << "; r=" << r << std::endl;
 #endif
 				if (r < s)
 				{
-					std::memcpy(pM, pItems, k * sizeof(ItemID));
-					std::memcpy(pM + k, pPfExt, pfExtCnt * sizeof(ItemID));
+					std::memcpy(m_pM, m_pItems, m_k * sizeof(ItemID));
+					std::memcpy(m_pM + m_k, m_pPfExt, pfExtCnt * sizeof(ItemID));
 
 #ifdef DEBUG
-					for (int32_t i = 0; i < k + pfExtCnt; i++)
-						LOG_DEBUG << pM[i] << " ";
+					for (int32_t i = 0; i < m_k + pfExtCnt; i++)
+						LOG_DEBUG << m_pM[i] << " ";
 					LOG_DEBUG << std::endl;
 #endif
 
-					cd.Update(pM, k + pfExtCnt, s);
-
-					PatternPair ppN;
-					ppN.first.reserve(k + pfExtCnt);
-					ppN.second = s;
-
-					for (PatternType p = 0; p < pp[Pattern::LEN_IDX]; p++)
-					{
-						PatternType id = pp[Pattern::DATA_IDX + p];
-						ppN.first.push_back(static_cast<PatternType>(pId2Item[id & 0xFFFFFFFF]));
-					}
-
-					closed.push_back(ppN);
+					m_cd.Update(m_pM, m_k + pfExtCnt, s);
+					m_closed.Add(pp + Pattern::DATA_IDX, static_cast<std::size_t>(pp[Pattern::LEN_IDX]), s, m_pId2Item);
 
 #ifdef DEBUG
 					LOG_DEBUG << std::endl
@@ -1055,18 +2506,272 @@ void ClosedDetection(const FPGrowth& fp, const Pattern* pPattern, std::vector<Pa
 #endif
 				}
 
-				if (k > 0) pAdded[pItems[--k]] = false;
-				cd.Remove(1);
+				if (m_k > 0) m_pAdded[m_pItems[--m_k]] = false;
+				m_cd.Remove(1);
 			}
 		}
 	}
 
-	delete[] pM;
-	delete[] pPfExt;
-	delete[] pItems;
-	delete[] pAdded;
+private:
+	std::size_t m_itemCount;
+	const ItemC* m_pId2Item;
+	PatternOutput m_closed;
+	Detect m_cd;
+	PatternType* m_pM;
+	PatternType* m_pPfExt;
+	PatternType* m_pItems;
+	bool* m_pAdded;
+	ItemID m_base;
+	int32_t m_k;
+};
+
+// Closed detection based on a hash index of the closed sets found so far,
+// requires the same bucket order as the ClosedFilter
+class HashClosedFilter
+{
+	DISABLE_COPY_ASSIGN_MOVE(HashClosedFilter)
+
+public:
+	HashClosedFilter(const FPGrowth& fp, const PatternOutput& closed) :
+		m_pId2Item(fp.GetId2Item()),
+		m_closed(closed),
+		m_index(),
+		m_pItems(nullptr)
+	{
+		m_pItems = new ItemID[fp.GetItemCount()];
+	}
+
+	~HashClosedFilter()
+	{
+		delete[] m_pItems;
+	}
+
+	void Process(const Pattern& pattern)
+	{
+		for (const PatternType* pp : pattern)
+		{
+#ifdef WITH_SIG_TERM
+			if (sigAborted()) throw(FPGException("CTRL-C abort"));
+#endif
+			const std::size_t len = static_cast<std::size_t>(pp[Pattern::LEN_IDX]);
+			const Support s       = static_cast<Support>(pp[Pattern::SUPP_IDX]);
+
+			for (std::size_t i = 0; i < len; i++)
+				m_pItems[i] = pp[Pattern::DATA_IDX + i] & 0xFFFFFFFF;
+
+			std::sort(m_pItems, m_pItems + len);
+
+			if (m_index.HasSuperset(m_pItems, len, s)) continue;
+
+			m_index.Add(m_pItems, len, s);
+			m_closed.Add(pp + Pattern::DATA_IDX, len, s, m_pId2Item);
+		}
+	}
+
+private:
+	const ItemC* m_pId2Item;
+	PatternOutput m_closed;
+	ClosedHash m_index;
+	ItemID* m_pItems;
+};
+
+// Removes the sets of the maximal growth that are covered by a set of a different bucket, afterwards
+// the maximal pattern length is applied. A superset of a set in bucket i can only be part of a bucket >= i
+// (the bucket of its least frequent item), therefore, the buckets have to be processed in descending order.
+class MaximalFilter
+{
+	DISABLE_COPY_ASSIGN_MOVE(MaximalFilter)
+
+public:
+	MaximalFilter(const FPGrowth& fp, const PatternOutput& maximal) :
+		m_pId2Item(fp.GetId2Item()),
+		m_maxPatternLen(fp.GetMaxPatternLen()),
+		m_maximal(maximal),
+		m_index()
+	{}
+
+	void Process(const Pattern& pattern)
+	{
+		// The sets of one bucket are already maximal among each other
+		for (const PatternType* pp : pattern)
+		{
+#ifdef WITH_SIG_TERM
+			if (sigAborted()) throw(FPGException("CTRL-C abort"));
+#endif
+			const std::size_t len  = static_cast<std::size_t>(pp[Pattern::LEN_IDX]);
+			const Support s        = static_cast<Support>(pp[Pattern::SUPP_IDX]);
+			const PatternType* pIt = pp + Pattern::DATA_IDX;
+
+			if (m_index.HasSuperset(pIt, len)) continue;
+
+			m_index.Add(pIt, len);
+
+			if (m_maxPatternLen != 0 && len > m_maxPatternLen) continue;
+
+			m_maximal.Add(pIt, len, s, m_pId2Item);
+		}
+	}
+
+private:
+	const ItemC* m_pId2Item;
+	uint32_t m_maxPatternLen;
+	PatternOutput m_maximal;
+	MaximalIndex m_index;
+};
+
+template<typename Filter>
+void runClosedDetection(const FPGrowth& fp, const Pattern* pPattern, const PatternOutput& closed)
+{
+	const std::size_t itemCount = fp.GetItemCount();
+	Filter filter(fp, closed);
+
+	for (int64_t patI = itemCount - 1; patI > -1; patI--)
+		filter.Process(pPattern[patI]);
+}
+
+template<typename Filter>
+bool runPipelinedClosedDetection(FPGrowth& fp, const PatternOutput& closed)
+{
+	Filter filter(fp, closed);
+	return fp.Growth([&filter](const Pattern& pattern) { filter.Process(pattern); });
+}
+
+std::string ToString(const ClosedAlgo& algo)
+{
+	switch (algo)
+	{
+		case ClosedAlgo::CA_HASH:
+			return "Hash Index";
+		case ClosedAlgo::CA_FLAT:
+			return "Flat Prefix Trees";
+		default:
+			return "Prefix Trees";
+	}
+}
+
+void ClosedDetection(const FPGrowth& fp, const Pattern* pPattern, const PatternOutput& closed, const ClosedAlgo& algo = ClosedAlgo::CA_TREE)
+{
+	if (fp.GetPatternCount() == 0)
+	{
+		LOG_INFO_EVAL << "No itemsets provided, skipping Closed Detection" << std::endl;
+		return;
+	}
+
+	Timer timer;
+
+	LOG_INFO_EVAL << "Closed Detection (" << ToString(algo) << ") ... " << std::flush;
+
+	timer.Start();
+
+	if (algo == ClosedAlgo::CA_HASH)
+		runClosedDetection<HashClosedFilter>(fp, pPattern, closed);
+	else if (algo == ClosedAlgo::CA_FLAT)
+		runClosedDetection<ClosedFilter<FlatClosedDetect>>(fp, pPattern, closed);
+	else
+		runClosedDetection<ClosedFilter<>>(fp, pPattern, closed);
+
+	timer.Stop();
+	LOG_INFO_EVAL << "Done after: " << timer << std::endl;
+	LOG_INFO << "Closed Pattern: " << closed.GetCount() << std::endl;
+}
+
+// Growth with the closed detection running concurrently on the finished buckets
+bool PipelinedClosedDetection(FPGrowth& fp, const PatternOutput& closed, const ClosedAlgo& algo = ClosedAlgo::CA_TREE)
+{
+	LOG_INFO_EVAL << "Pipelined Closed Detection (" << ToString(algo) << ")" << std::endl;
+
+	bool res;
+	if (algo == ClosedAlgo::CA_HASH)
+		res = runPipelinedClosedDetection<HashClosedFilter>(fp, closed);
+	else if (algo == ClosedAlgo::CA_FLAT)
+		res = runPipelinedClosedDetection<ClosedFilter<FlatClosedDetect>>(fp, closed);
+	else
+		res = runPipelinedClosedDetection<ClosedFilter<>>(fp, closed);
 
+	if (!res) return false;
+
+	LOG_INFO << "Closed Pattern: " << closed.GetCount() << std::endl;
+	return true;
+}
+
+void MaximalDetection(const FPGrowth& fp, const Pattern* pPattern, const PatternOutput& maximal)
+{
+	Timer timer;
+
+	LOG_INFO_EVAL << "Maximal Detection ... " << std::flush;
+
+	timer.Start();
+	runClosedDetection<MaximalFilter>(fp, pPattern, maximal);
 	timer.Stop();
+
 	LOG_INFO_EVAL << "Done after: " << timer << std::endl;
-	LOG_INFO << "Closed Pattern: " << closed.size() << std::endl;
+	LOG_INFO << "Maximal Pattern: " << maximal.GetCount() << std::endl;
+}
+
+// Maximal growth with the cross-bucket maximal filter running concurrently on the finished buckets
+bool PipelinedMaximalDetection(FPGrowth& fp, const PatternOutput& maximal)
+{
+	LOG_INFO_EVAL << "Pipelined Maximal Detection" << std::endl;
+
+	if (!runPipelinedClosedDetection<MaximalFilter>(fp, maximal)) return false;
+
+	LOG_INFO << "Maximal Pattern: " << maximal.GetCount() << std::endl;
+	return true;
+}
+
+// Selects the sets of a job from the closed sets of a growth with the loosest parameters of all jobs (lowest support,
+// zmin and min_neu, highest max_c), the sets contain the items not their ids. The closedness does not depend on the
+// job parameters, the maximal sets of a job are the closed sets with at least its support that have no superset among
+// them. Afterwards, the same output filters as for a single run are applied.
+void JobDetection(const std::vector<PatternPair>& closed, const Job& job, const ItemC& winLen, const Target& target, std::vector<PatternPair>& res)
+{
+	const auto accept = [&job, &winLen](const PatternVec& items, const Support& supp) {
+		if (items.size() < job.minPatternLen || (job.maxPatternLen != 0 && items.size() > job.maxPatternLen)) return false;
+		if (supp > job.maxSupport) return false;
+		if (std::none_of(std::begin(items), std::end(items), [&winLen](const PatternType& i) { return (i % winLen) == 0; })) return false;
+
+		std::set<PatternType> neurons;
+		std::transform(std::begin(items), std::end(items), std::inserter(neurons, std::begin(neurons)), [&winLen](const PatternType& i) { return i / winLen; });
+		return neurons.size() >= job.minNeuronCount;
+	};
+
+	if (target != Target::TA_MAXIMAL)
+	{
+		for (const PatternPair& pp : closed)
+		{
+#ifdef WITH_SIG_TERM
+			if (sigAborted()) throw(FPGException("CTRL-C abort"));
+#endif
+			if (pp.second >= job.minSupport && accept(pp.first, pp.second))
+				res.push_back(pp);
+		}
+
+		return;
+	}
+
+	// A superset has more items, hence, the sets are checked in descending length
+	std::vector<const PatternPair*> sets;
+	for (const PatternPair& pp : closed)
+		if (pp.second >= job.minSupport) sets.push_back(&pp);
+
+	std::stable_sort(std::begin(sets), std::end(sets), [](const PatternPair* pA, const PatternPair* pB) { return pA->first.size() > pB->first.size(); });
+
+	MaximalIndex index;
+	std::vector<ItemID> items;
+
+	for (const PatternPair* pPP : sets)
+	{
+#ifdef WITH_SIG_TERM
+		if (sigAborted()) throw(FPGException("CTRL-C abort"));
+#endif
+		items.assign(std::begin(pPP->first), std::end(pPP->first));
+		std::sort(std::begin(items), std::end(items));
+
+		if (index.HasSuperset(items.data(), items.size())) continue;
+
+		index.Add(items.data(), items.size());
+
+		if (accept(pPP->first, pPP->second))
+			res.push_back(*pPP);
+	}
 }
@@ -37,6 +37,7 @@ struct FPNode
 {
 	std::size_t id;
 	Support support;
+	uint32_t depth; // Number of nodes on the path to the root (excluding the root)
 	struct FPNode* parent;
 	struct FPNode* succ;
 #ifdef DEBUG
@@ -46,6 +47,7 @@ struct FPNode
 	FPNode() :
 		id(std::numeric_limits<size_t>::max()),
 		support(0),
+		depth(0),
 		parent(nullptr),
 		succ(nullptr)
 #ifdef DEBUG
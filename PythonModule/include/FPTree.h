@@ -138,6 +138,7 @@ struct FPTree
 			c = pMemory->Alloc();
 			c->id = id;
 			c->support = support;
+			c->depth = pNode->depth + 1;
 			c->parent = pNode;
 			c->succ = pHeads[id].list;
 #ifdef DEBUG
@@ -176,6 +177,7 @@ struct FPTree
 			c = pMemory->Alloc();
 			c->id = id;
 			c->support = support;
+			c->depth = pNode->depth + 1;
 			c->parent = pNode;
 			c->succ = pHeads[id].list;
 #ifdef DEBUG
@@ -0,0 +1,463 @@
+/*
+ *  File: FlatClosedTree.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+/*
+ * Variant of the ClosedTree / ClosedDetect pair that stores the nodes of all
+ * trees in flat arrays linked by 32-bit indices instead of one memory pool per
+ * tree. The repository tree (depth 0) owns one arena, all projected trees share
+ * a second one. As the closed sets are added to every tree on the stack, the
+ * nodes of different depths interleave, therefore, deeper trees are returned to
+ * the free list of the shared arena and the whole arena is rolled back once the
+ * outermost projection is cleared.
+ */
+
+#pragma once
+
+#include "Types.h"
+#include "Utils.h"
+
+#include <limits>
+#include <vector>
+
+struct FlatClosedNode
+{
+	uint32_t item;
+	Support supp;
+	uint32_t sibling;
+	uint32_t children;
+};
+
+class ClosedArena
+{
+	DISABLE_COPY_ASSIGN_MOVE(ClosedArena)
+
+public:
+	static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+	ClosedArena() :
+		m_nodes(),
+		m_free(NIL)
+	{}
+
+	uint32_t Alloc()
+	{
+		if (m_free != NIL)
+		{
+			uint32_t idx = m_free;
+			m_free       = m_nodes[idx].sibling;
+			return idx;
+		}
+
+		m_nodes.push_back(FlatClosedNode());
+		return static_cast<uint32_t>(m_nodes.size() - 1);
+	}
+
+	void Free(const uint32_t& idx)
+	{
+		m_nodes[idx].sibling = m_free;
+		m_free               = idx;
+	}
+
+	// Returns a complete (sub-)tree, including all siblings, to the free list
+	void FreeTree(uint32_t idx)
+	{
+		while (idx != NIL)
+		{
+			uint32_t next = m_nodes[idx].sibling;
+			FreeTree(m_nodes[idx].children);
+			Free(idx);
+			idx = next;
+		}
+	}
+
+	// Rolls back all allocations, the capacity is kept for the next use
+	void Reset()
+	{
+		m_nodes.clear();
+		m_free = NIL;
+	}
+
+	FlatClosedNode& operator[](const uint32_t& idx)
+	{
+		return m_nodes[idx];
+	}
+
+	const FlatClosedNode& operator[](const uint32_t& idx) const
+	{
+		return m_nodes[idx];
+	}
+
+private:
+	std::vector<FlatClosedNode> m_nodes;
+	uint32_t m_free;
+};
+
+class FlatClosedTree
+{
+	DISABLE_COPY_ASSIGN_MOVE(FlatClosedTree)
+
+	static constexpr uint32_t NIL = ClosedArena::NIL;
+
+public:
+	FlatClosedTree() :
+		m_pArena(nullptr),
+		m_item(ITEM_MAX),
+		m_max(0),
+		m_root(NIL)
+	{}
+
+	void Init(ClosedArena* pArena)
+	{
+		m_pArena = pArena;
+		m_item   = ITEM_MAX;
+		m_max    = 0;
+		m_root   = newNode(ITEM_MAX, 0);
+	}
+
+	bool Valid() const
+	{
+		return m_item < ITEM_MAX;
+	}
+
+	void Add(const ItemID* pItems, int32_t n, Support supp)
+	{
+		ClosedArena& a = *m_pArena;
+		uint32_t i     = 0;
+		uint32_t node  = m_root;
+		uint32_t owner;
+		bool childLink;
+
+		if (supp > m_max) m_max = supp;
+
+		do
+		{
+			if (supp > a[node].supp) a[node].supp = supp;
+			if (--n < 0) return;
+
+			i         = static_cast<uint32_t>(*pItems++);
+			owner     = node;
+			childLink = true;
+			node      = a[owner].children;
+
+			while (node != NIL && a[node].item > i)
+			{
+				owner     = node;
+				childLink = false;
+				node      = a[node].sibling;
+			}
+		} while (node != NIL && a[node].item == i);
+
+		// Allocations can relocate the nodes, hence, only keep indices
+		node                    = newNode(i, supp);
+		a[node].sibling        = link(owner, childLink);
+		link(owner, childLink) = node;
+
+		while (--n >= 0)
+		{
+			uint32_t c = newNode(static_cast<uint32_t>(*pItems++), supp);
+			a[node].children = c;
+			node             = c;
+		}
+	}
+
+	FlatClosedTree* Project(FlatClosedTree* pDst, ClosedArena* pDstArena)
+	{
+		ClosedArena& a = *m_pArena;
+
+		pDst->Init(pDstArena);
+		pDst->SetItem(ITEM_MAX - 1);
+		pDst->SetMax(0);
+		m_max = 0;
+
+		if (a[m_root].children == NIL) return pDst;
+
+		uint32_t p = a[m_root].children = prune(a[m_root].children, m_item);
+
+		if (p == NIL || a[p].item != m_item) return pDst;
+
+		(*pDstArena)[pDst->m_root].supp = a[p].supp;
+		m_max                           = a[p].supp;
+
+		if (a[p].children != NIL)
+		{
+			uint32_t c                          = pDst->copy(a, a[p].children);
+			(*pDstArena)[pDst->m_root].children = c;
+		}
+
+		a[m_root].children = prune(a[m_root].children, m_item + 1);
+
+		return pDst;
+	}
+
+	void Prune(const ItemID& item)
+	{
+		ClosedArena& a = *m_pArena;
+
+		m_item = item;
+
+		uint32_t p = a[m_root].children = prune(a[m_root].children, item);
+		m_max                           = (p != NIL && (a[p].item == item)) ? a[p].supp : 0;
+	}
+
+	// Returns the nodes to the arena, rollback=true if the complete arena
+	// is released by the caller afterwards
+	void Clear(const bool& rollback = false)
+	{
+		if (!rollback && m_root != NIL)
+			m_pArena->FreeTree(m_root);
+
+		m_root = NIL;
+		m_max  = 0;
+		m_item = ITEM_MAX;
+	}
+
+	const ItemID& GetItem() const
+	{
+		return m_item;
+	}
+
+	const Support& GetMax() const
+	{
+		return m_max;
+	}
+
+	Support GetSupport() const
+	{
+		return (*m_pArena)[m_root].supp;
+	}
+
+	void SetItem(const ItemID& item)
+	{
+		m_item = item;
+	}
+
+	void SetMax(const Support& max)
+	{
+		m_max = max;
+	}
+
+private:
+	uint32_t newNode(const uint32_t& item, const Support& supp)
+	{
+		uint32_t idx         = m_pArena->Alloc();
+		FlatClosedNode& node = (*m_pArena)[idx];
+		node.item            = item;
+		node.supp            = supp;
+		node.sibling         = NIL;
+		node.children        = NIL;
+		return idx;
+	}
+
+	uint32_t& link(const uint32_t& owner, const bool& childLink)
+	{
+		return childLink ? (*m_pArena)[owner].children : (*m_pArena)[owner].sibling;
+	}
+
+	// merge and prune do not allocate, therefore, pointers into the arena stay valid
+	uint32_t merge(uint32_t s1, uint32_t s2)
+	{
+		ClosedArena& a = *m_pArena;
+		uint32_t out   = NIL;
+		uint32_t* pEnd = &out;
+		uint32_t p;
+
+		if (s1 == NIL) return s2;
+		if (s2 == NIL) return s1;
+
+		while (1)
+		{
+			if (a[s1].item > a[s2].item)
+			{
+				*pEnd = s1;
+				pEnd  = &a[s1].sibling;
+				s1    = *pEnd;
+				if (s1 == NIL) break;
+			}
+			else if (a[s2].item > a[s1].item)
+			{
+				*pEnd = s2;
+				pEnd  = &a[s2].sibling;
+				s2    = *pEnd;
+				if (s2 == NIL) break;
+			}
+			else
+			{
+				a[s1].children = merge(a[s1].children, a[s2].children);
+				if (a[s1].supp < a[s2].supp)
+					a[s1].supp = a[s2].supp;
+
+				p  = s2;
+				s2 = a[s2].sibling;
+				a.Free(p);
+
+				*pEnd = s1;
+				pEnd  = &a[s1].sibling;
+				s1    = *pEnd;
+				if (s1 == NIL || s2 == NIL) break;
+			}
+		}
+
+		*pEnd = (s1 != NIL) ? s1 : s2;
+		return out;
+	}
+
+	uint32_t prune(uint32_t node, const ItemID& item)
+	{
+		ClosedArena& a = *m_pArena;
+		uint32_t p;
+		uint32_t b = NIL;
+
+		while (node != NIL && (a[node].item > item))
+		{
+			a[node].children = p = prune(a[node].children, item);
+			if (p != NIL) b = (b == NIL) ? p : merge(b, p);
+			p    = node;
+			node = a[node].sibling;
+			a.Free(p);
+		}
+
+		return (node == NIL) ? b : (b == NIL) ? node : merge(b, node);
+	}
+
+	uint32_t copy(const ClosedArena& src, uint32_t srcIdx)
+	{
+		uint32_t first = NIL;
+		uint32_t prev  = NIL;
+
+		do
+		{
+			uint32_t node = newNode(src[srcIdx].item, src[srcIdx].supp);
+			uint32_t c    = src[srcIdx].children;
+
+			if (c != NIL)
+			{
+				c = copy(src, c);
+				(*m_pArena)[node].children = c;
+			}
+
+			if (prev == NIL)
+				first = node;
+			else
+				(*m_pArena)[prev].sibling = node;
+
+			prev   = node;
+			srcIdx = src[srcIdx].sibling;
+		} while (srcIdx != NIL);
+
+		return first;
+	}
+
+private:
+	ClosedArena* m_pArena;
+	ItemID m_item;
+	Support m_max;
+	uint32_t m_root;
+};
+
+class FlatClosedDetect
+{
+	DISABLE_COPY_ASSIGN_MOVE(FlatClosedDetect)
+
+public:
+	FlatClosedDetect(const std::size_t& size) :
+		m_size(size),
+		m_cnt(0),
+		m_pTrees(nullptr),
+		m_repoArena(),
+		m_projArena()
+	{
+		m_pTrees = new FlatClosedTree[size + 1];
+		m_pTrees[0].Init(&m_repoArena);
+		m_pTrees[0].Add(nullptr, 0, 0);
+		m_pTrees[0].SetItem(ITEM_MAX - 1);
+	}
+
+	~FlatClosedDetect()
+	{
+		delete[] m_pTrees;
+	}
+
+	int Add2(ItemID item, Support supp)
+	{
+		FlatClosedTree* t = m_pTrees + m_cnt;
+
+		if (!t->Valid())
+		{
+			FlatClosedTree* prev = m_pTrees + (m_cnt - 1);
+			t                    = prev->Project(t, &m_projArena);
+		}
+
+		t->Prune(item);
+
+		if (t->GetMax() >= supp) return 0;
+
+		++m_cnt;
+		return 1;
+	}
+
+	int Update(ItemID* items, int32_t n, const Support& supp)
+	{
+		for (size_t i = 0; i < m_cnt; i++)
+		{
+			FlatClosedTree* t = &m_pTrees[i];
+			while (*items != t->GetItem())
+			{
+				++items;
+				--n;
+			}
+
+			t->Add(++items, --n, supp);
+		}
+		return 0;
+	}
+
+	void Remove(std::size_t n)
+	{
+		for (n = (n < m_cnt) ? m_cnt - n : 0; m_cnt > n; m_cnt--)
+		{
+			if (m_pTrees[m_cnt].Valid())
+			{
+				// All nodes of the projection arena belong to the outermost
+				// projection or deeper ones, therefore, roll back the arena
+				const bool outermost = (m_cnt == 1);
+				m_pTrees[m_cnt].Clear(outermost);
+				if (outermost) m_projArena.Reset();
+			}
+		}
+	}
+
+	Support GetSupport() const
+	{
+		return (m_cnt > 0) ? m_pTrees[m_cnt - 1].GetMax() : m_pTrees[0].GetSupport();
+	}
+
+private:
+	std::size_t m_size;
+	std::size_t m_cnt;
+	FlatClosedTree* m_pTrees;
+	ClosedArena m_repoArena;
+	ClosedArena m_projArena;
+};
@@ -0,0 +1,129 @@
+/*
+ *  File: MaximalIndex.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+/*
+ * Repository of maximal item sets for the subset checks of the maximal growth
+ * (the role of the MFI-tree in FPMax). The sets are stored consecutively and
+ * indexed by their single items as well as by all their item pairs. A query
+ * only has to check the sets containing its two least frequent items (the
+ * highest ids), as the posting lists of single items are too long for the
+ * large number of sets the maximal growth produces.
+ */
+
+#pragma once
+
+#include "Types.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+class MaximalIndex
+{
+	DISABLE_COPY_ASSIGN_MOVE(MaximalIndex)
+
+	using Key      = uint64_t;
+	using Postings = std::vector<uint32_t>;
+
+public:
+	MaximalIndex() :
+		m_items(),
+		m_offsets(1, 0),
+		m_index()
+	{}
+
+	// Adds a maximal set, the items have to be sorted in ascending order
+	void Add(const ItemID* pItems, const std::size_t& n)
+	{
+		const uint32_t setIdx = static_cast<uint32_t>(m_offsets.size() - 1);
+
+		m_items.insert(std::end(m_items), pItems, pItems + n);
+		m_offsets.push_back(m_items.size());
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			m_index[makeKey(pItems[i])].push_back(setIdx);
+
+			for (std::size_t j = i + 1; j < n; j++)
+				m_index[makeKey(pItems[i], pItems[j])].push_back(setIdx);
+		}
+	}
+
+	// Checks if a superset (or the set itself) has been added before,
+	// the items have to be sorted in ascending order
+	bool HasSuperset(const ItemID* pItems, const std::size_t& n) const
+	{
+		if (n == 0) return GetCount() > 0;
+
+		auto it = m_index.find((n == 1) ? makeKey(pItems[0]) : makeKey(pItems[n - 2], pItems[n - 1]));
+
+		// No maximal set contains the items
+		if (it == m_index.end()) return false;
+
+		for (const uint32_t& setIdx : it->second)
+		{
+			const ItemID* pBegin = m_items.data() + m_offsets[setIdx];
+			const ItemID* pEnd   = m_items.data() + m_offsets[setIdx + 1];
+
+			if (static_cast<std::size_t>(pEnd - pBegin) < n) continue;
+
+			if (std::includes(pBegin, pEnd, pItems, pItems + n))
+				return true;
+		}
+
+		return false;
+	}
+
+	void Clear()
+	{
+		m_items.clear();
+		m_offsets.assign(1, 0);
+		m_index.clear();
+	}
+
+	std::size_t GetCount() const
+	{
+		return m_offsets.size() - 1;
+	}
+
+private:
+	// The item ids are limited to 32-bit, single items use the invalid pair (item, item)
+	static Key makeKey(const ItemID& item)
+	{
+		return makeKey(item, item);
+	}
+
+	static Key makeKey(const ItemID& first, const ItemID& second)
+	{
+		return ((first & 0xFFFFFFFF) << 32) | (second & 0xFFFFFFFF);
+	}
+
+private:
+	std::vector<ItemID> m_items;
+	std::vector<std::size_t> m_offsets;
+	std::unordered_map<Key, Postings> m_index;
+};
@@ -152,6 +152,17 @@ public:
 #endif
 	}
 
+	const std::size_t& GetInUse() const
+	{
+		return m_inUse;
+	}
+
+	// Memory of all allocated blocks, these are kept until the destruction (i.e., the peak usage)
+	std::size_t GetBytes() const
+	{
+		return m_pMem.size() * m_elems * sizeof(T);
+	}
+
 	void Clear()
 	{
 		m_inUse = 0;
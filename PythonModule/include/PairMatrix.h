@@ -0,0 +1,134 @@
+/*
+ *  File: PairMatrix.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+/*
+ * Triangular matrix with the supports of all item pairs, the items are given as
+ * dense indices (0 .. itemCount - 1). The transactions are counted in parallel.
+ */
+
+#pragma once
+
+#include "Types.h"
+#include "Utils.h"
+
+#include <vector>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+class PairMatrix
+{
+	DISABLE_COPY_ASSIGN_MOVE(PairMatrix)
+
+	// Upper limit of the matrix entries (64 MB of counters)
+	static constexpr std::size_t MAX_ENTRIES = std::size_t(1) << 24;
+
+public:
+	PairMatrix(const std::size_t& itemCount) :
+		m_itemCount(itemCount),
+		m_counts(entries(itemCount), 0)
+	{}
+
+	static bool Fits(const std::size_t& itemCount)
+	{
+		return entries(itemCount) <= MAX_ENTRIES;
+	}
+
+	// Counts all pairs of the transactions (dense item indices, sorted without duplicates),
+	// the counters are only incremented atomically if multiple threads are available
+	void Count(const std::vector<std::vector<uint32_t>>& transactions)
+	{
+#ifdef USE_OPENMP
+		if (omp_get_max_threads() > 1)
+		{
+			const int64_t cnt = static_cast<int64_t>(transactions.size());
+
+#pragma omp parallel for schedule(dynamic, 64)
+			for (int64_t t = 0; t < cnt; t++)
+				count<true>(transactions[t]);
+
+			return;
+		}
+#endif
+
+		for (const std::vector<uint32_t>& trans : transactions)
+			count<false>(trans);
+	}
+
+	const Support& Get(const uint32_t& a, const uint32_t& b) const
+	{
+		return m_counts[index(a, b)];
+	}
+
+	const std::size_t& GetItemCount() const
+	{
+		return m_itemCount;
+	}
+
+private:
+	template<bool ATOMIC>
+	void count(const std::vector<uint32_t>& trans)
+	{
+		for (std::size_t i = 1; i < trans.size(); i++)
+		{
+			Support* pRow = m_counts.data() + rowOffset(trans[i]);
+			for (std::size_t j = 0; j < i; j++)
+			{
+				if constexpr (ATOMIC)
+				{
+#ifdef USE_OPENMP
+#pragma omp atomic
+#endif
+					pRow[trans[j]]++;
+				}
+				else
+					pRow[trans[j]]++;
+			}
+		}
+	}
+
+	static std::size_t rowOffset(const std::size_t& hi)
+	{
+		return hi * (hi - 1) / 2;
+	}
+
+	static std::size_t entries(const std::size_t& itemCount)
+	{
+		return (itemCount < 2) ? 0 : itemCount * (itemCount - 1) / 2;
+	}
+
+	static std::size_t index(const uint32_t& a, const uint32_t& b)
+	{
+		const std::size_t hi = (a > b) ? a : b;
+		const std::size_t lo = (a > b) ? b : a;
+		return rowOffset(hi) + lo;
+	}
+
+private:
+	std::size_t m_itemCount;
+	std::vector<Support> m_counts;
+};
@@ -52,7 +52,6 @@ public:
 		m_mem(),
 		m_pEndPtr(nullptr)
 	{
-		allocNewPatternBlock();
 	}
 
 	~Pattern()
@@ -77,7 +76,7 @@ public:
 			m_mem(mem),
 			m_pItr(pItr)
 		{
-			if (m_pItr == nullptr)
+			if (m_pItr == nullptr && m_maxBlocks > 0)
 				m_pItr = m_mem[m_block];
 		}
 
@@ -131,6 +130,12 @@ public:
 		return m_patternCnt == 0;
 	}
 
+	// Memory of the allocated pattern blocks
+	std::size_t GetBytes() const
+	{
+		return m_block * BLOCK_SIZE * sizeof(PatternType);
+	}
+
 	Iterator begin()
 	{
 		return Iterator(m_mem, m_block);
@@ -171,6 +176,14 @@ public:
 	}
 
 	void AddPattern(const std::size_t& patternLength, const Support& support, PatternType* pData, const ItemC* pId2Item, const Support& maxSupport, const std::size_t& minNeuronCount, const ItemC& winLen)
+	{
+		if (Accept(patternLength, support, pData, pId2Item, maxSupport, minNeuronCount, winLen))
+			AddPattern(patternLength, support, pData);
+	}
+
+	// Output filter of the pattern: Requires an item with lag 0, a support of at most maxSupport
+	// and at least minNeuronCount distinct neurons (item / winLen)
+	static bool Accept(const std::size_t& patternLength, const Support& support, const PatternType* pData, const ItemC* pId2Item, const Support& maxSupport, const std::size_t& minNeuronCount, const ItemC& winLen)
 	{
 		const PatternType* pStart = pData;
 		const PatternType* pEnd   = pData + patternLength;
@@ -180,29 +193,37 @@ public:
 			{
 				std::set<PatternType> v;
 				std::transform(pStart, pEnd, std::inserter(v, std::begin(v)), [&winLen, &pId2Item](const PatternType& i) { return (pId2Item[i & 0xFFFFFFFF]) / winLen; });
-				if (v.size() >= minNeuronCount)
-				{
-					PatternType* pPattern = getNextPattern(patternLength);
-					pPattern[LEN_IDX]     = patternLength; // Set pattern length
-					pPattern[SUPP_IDX]    = support;       // Set pattern support
-					// Set pattern data
-					std::memcpy(pPattern + OFFSET, pData, patternLength * sizeof(PatternType));
-#ifdef DEBUG
-					LOG_DEBUG << "Adding Pattern: " << std::flush;
-					for (PatternType i = 0; i < patternLength; i++)
-						LOG_DEBUG << (char)pData[i] << " ";
-					LOG_DEBUG << "(" << support << ")" << std::endl;
-#endif
-					m_patternCnt++;
-				}
+				return v.size() >= minNeuronCount;
 			}
 		}
+
+		return false;
+	}
+
+	// Checks if the lags (item % winLen) of the pattern span at most maxDuration
+	static bool WithinDuration(const std::size_t& patternLength, const PatternType* pData, const ItemC* pId2Item, const ItemC& winLen, const uint32_t& maxDuration)
+	{
+		const auto [pMin, pMax] = std::minmax_element(pData, pData + patternLength, [&winLen, &pId2Item](const PatternType& a, const PatternType& b) { return (pId2Item[a & 0xFFFFFFFF] % winLen) < (pId2Item[b & 0xFFFFFFFF] % winLen); });
+		return patternLength == 0 || (pId2Item[*pMax & 0xFFFFFFFF] % winLen) - (pId2Item[*pMin & 0xFFFFFFFF] % winLen) <= maxDuration;
+	}
+
+	// Releases all pattern blocks, new blocks are only allocated once the next pattern is added
+	void Clear()
+	{
+		for (std::size_t i = 0; i < m_block; i++)
+			delete[] m_mem[i];
+
+		m_mem.clear();
+		m_nextIdx    = 0;
+		m_block      = 0;
+		m_patternCnt = 0;
+		m_pEndPtr    = nullptr;
 	}
 
 private:
 	PatternType* getNextPattern(const std::size_t& length)
 	{
-		if (m_nextIdx + (length + OFFSET) >= BLOCK_SIZE)
+		if (m_block == 0 || m_nextIdx + (length + OFFSET) >= BLOCK_SIZE)
 			allocNewPatternBlock();
 
 		PatternType* pPtr = m_mem[m_block - 1] + m_nextIdx;
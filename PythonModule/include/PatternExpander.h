@@ -0,0 +1,264 @@
+/*
+ *  File: PatternExpander.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+/*
+ * Compressed storage of the itemsets generated by the growth: Every itemset is stored
+ * once as (base items, perfect extensions, support) and only expanded into the sets
+ * B u S (S subset of the perfect extensions, all with the same support) when they are
+ * requested. The output filters are applied to every expanded set individually.
+ */
+
+#pragma once
+
+#include "FPGrowth.h"
+#include "Pattern.h"
+#include "Types.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <vector>
+
+class PatternExpander
+{
+	DISABLE_COPY_ASSIGN_MOVE(PatternExpander)
+
+	// Record layout: [base length, extension length, support, base items..., extension items...]
+	static constexpr std::size_t BASE_LEN_IDX = 0;
+	static constexpr std::size_t EXT_LEN_IDX  = 1;
+	static constexpr std::size_t SUPP_IDX     = 2;
+	static constexpr std::size_t DATA_IDX     = 3;
+
+public:
+	PatternExpander(const FPGrowth& fp) :
+		m_id2Item(fp.GetId2Item(), fp.GetId2Item() + fp.GetItemCount()),
+		m_minPatternLen(fp.GetMinPatternLen()),
+		m_maxPatternLen(fp.GetMaxPatternLen()),
+		m_winLen(fp.GetWinLen()),
+		m_maxSupport(fp.GetMaxSupport()),
+		m_minNeuronCount(fp.GetMinNeuronCount()),
+		m_maxDuration(fp.GetMaxDuration()),
+		m_sizeSupports(fp.GetSizeSupports()),
+		m_data(),
+		m_recordCnt(0),
+		m_pos(0),
+		m_inRecord(false),
+		m_size(0),
+		m_maxSize(0),
+		m_comb(),
+		m_set()
+	{}
+
+	// Takes over the records of a bucket, the perfect extensions are the items tagged with support 0
+	void Add(const Pattern& pattern)
+	{
+		for (const PatternType* pp : pattern)
+		{
+#ifdef WITH_SIG_TERM
+			if (sigAborted()) throw(FPGException("CTRL-C abort"));
+#endif
+			const PatternType* pStart = pp + Pattern::DATA_IDX;
+			const PatternType* pEnd   = pStart + pp[Pattern::LEN_IDX];
+			const auto isExt          = [](const PatternType& i) { return (i >> 32) == 0; };
+
+			m_data.push_back(static_cast<PatternType>(std::count_if(pStart, pEnd, [&isExt](const PatternType& i) { return !isExt(i); })));
+			m_data.push_back(static_cast<PatternType>(std::count_if(pStart, pEnd, isExt)));
+			m_data.push_back(pp[Pattern::SUPP_IDX]);
+
+			for (const PatternType* pIt = pStart; pIt != pEnd; pIt++)
+				if (!isExt(*pIt)) m_data.push_back(*pIt & 0xFFFFFFFF);
+
+			for (const PatternType* pIt = pStart; pIt != pEnd; pIt++)
+				if (isExt(*pIt)) m_data.push_back(*pIt);
+
+			m_recordCnt++;
+		}
+	}
+
+	std::size_t GetRecordCount() const
+	{
+		return m_recordCnt;
+	}
+
+	const std::vector<ItemC>& GetId2Item() const
+	{
+		return m_id2Item;
+	}
+
+	// Calls func(base, extensions, support) with the item ids of every compressed record
+	template<typename Func>
+	void ForEachRecord(Func func) const
+	{
+		PatternVec base;
+		PatternVec ext;
+
+		for (std::size_t pos = 0; pos < m_data.size(); pos += recordSize(pos))
+		{
+			const PatternType* pBase = m_data.data() + pos + DATA_IDX;
+			const PatternType* pExt  = pBase + m_data[pos + BASE_LEN_IDX];
+
+			base.assign(pBase, pExt);
+			ext.assign(pExt, pExt + m_data[pos + EXT_LEN_IDX]);
+			func(base, ext, static_cast<Support>(m_data[pos + SUPP_IDX]));
+		}
+	}
+
+	// Writes the item ids of the next expanded set that passes the output filters,
+	// returns false once all records are expanded
+	bool Next(PatternVec& items, Support& supp)
+	{
+		while (m_pos < m_data.size())
+		{
+			const std::size_t baseLen = static_cast<std::size_t>(m_data[m_pos + BASE_LEN_IDX]);
+			const std::size_t extLen  = static_cast<std::size_t>(m_data[m_pos + EXT_LEN_IDX]);
+
+			if (!m_inRecord)
+			{
+				// Only the extension sizes that lead to a valid pattern length are enumerated
+				m_size    = (m_minPatternLen > baseLen) ? m_minPatternLen - baseLen : 0;
+				m_maxSize = extLen;
+				if (m_maxPatternLen != 0)
+					m_maxSize = (baseLen > m_maxPatternLen) ? 0 : std::min(extLen, m_maxPatternLen - baseLen);
+
+				skipSizes(baseLen, static_cast<Support>(m_data[m_pos + SUPP_IDX]));
+
+				m_inRecord = (m_size <= m_maxSize) && (m_maxPatternLen == 0 || baseLen <= m_maxPatternLen);
+				if (m_inRecord) firstCombination();
+			}
+			else if (!nextCombination(extLen))
+			{
+				m_size++;
+				skipSizes(baseLen, static_cast<Support>(m_data[m_pos + SUPP_IDX]));
+
+				if (m_size <= m_maxSize)
+					firstCombination();
+				else
+					m_inRecord = false;
+			}
+
+			if (!m_inRecord)
+			{
+				m_pos += recordSize(m_pos);
+				continue;
+			}
+
+			const PatternType* pBase = m_data.data() + m_pos + DATA_IDX;
+			const PatternType* pExt  = pBase + baseLen;
+
+			m_set.assign(pBase, pBase + baseLen);
+			for (const std::size_t& c : m_comb)
+				m_set.push_back(pExt[c]);
+
+			supp = static_cast<Support>(m_data[m_pos + SUPP_IDX]);
+
+			if (Pattern::Accept(m_set.size(), supp, m_set.data(), m_id2Item.data(), m_maxSupport, m_minNeuronCount, m_winLen) && Pattern::WithinDuration(m_set.size(), m_set.data(), m_id2Item.data(), m_winLen, m_maxDuration))
+			{
+				items = m_set;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	std::size_t recordSize(const std::size_t& pos) const
+	{
+		return DATA_IDX + static_cast<std::size_t>(m_data[pos + BASE_LEN_IDX] + m_data[pos + EXT_LEN_IDX]);
+	}
+
+	// Skips the extension sizes whose pattern length requires a higher support than the one of the record
+	void skipSizes(const std::size_t& baseLen, const Support& supp)
+	{
+		while (m_size <= m_maxSize && supp < m_sizeSupports[std::min(baseLen + m_size, m_sizeSupports.size() - 1)])
+			m_size++;
+	}
+
+	void firstCombination()
+	{
+		m_comb.resize(m_size);
+		for (std::size_t i = 0; i < m_size; i++)
+			m_comb[i] = i;
+	}
+
+	// Advances to the next combination of m_size out of n extensions in lexicographic order
+	bool nextCombination(const std::size_t& n)
+	{
+		for (std::size_t i = m_size; i-- > 0;)
+		{
+			if (m_comb[i] < n - m_size + i)
+			{
+				m_comb[i]++;
+				for (std::size_t j = i + 1; j < m_size; j++)
+					m_comb[j] = m_comb[j - 1] + 1;
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	std::vector<ItemC> m_id2Item;
+	std::size_t m_minPatternLen;
+	std::size_t m_maxPatternLen;
+	ItemC m_winLen;
+	Support m_maxSupport;
+	std::size_t m_minNeuronCount;
+	uint32_t m_maxDuration;
+	std::vector<Support> m_sizeSupports;
+
+	std::vector<PatternType> m_data;
+	std::size_t m_recordCnt;
+
+	// Expansion state
+	std::size_t m_pos;
+	bool m_inRecord;
+	std::size_t m_size;
+	std::size_t m_maxSize;
+	std::vector<std::size_t> m_comb;
+	PatternVec m_set;
+};
+
+// Growth storing the compressed patterns in the expander, the buckets are released once they are copied
+bool CompressedGrowth(FPGrowth& fp, PatternExpander& expander, const bool& pipelined)
+{
+	if (pipelined)
+	{
+		if (!fp.Growth([&expander](const Pattern& pattern) { expander.Add(pattern); })) return false;
+	}
+	else
+	{
+		const Pattern* pPattern = fp.Growth();
+		if (pPattern == nullptr) return false;
+
+		for (std::size_t i = 0; i < fp.GetItemCount(); i++)
+			expander.Add(pPattern[i]);
+	}
+
+	LOG_INFO << "Compressed Pattern: " << expander.GetRecordCount() << std::endl;
+	return true;
+}
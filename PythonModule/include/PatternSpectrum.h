@@ -0,0 +1,115 @@
+/*
+ *  File: PatternSpectrum.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+
+/*
+ * Pattern spectrum: Number of sets per (size, support) and optionally per duration
+ * (max. lag - min. lag of the items) as used by the significance tests of SPADE.
+ * The sets are only counted, hence, the memory does not depend on the number of sets.
+ */
+
+#pragma once
+
+#include "Types.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <vector>
+
+class PatternSpectrum
+{
+	DISABLE_COPY_ASSIGN_MOVE(PatternSpectrum)
+
+public:
+	using Key = std::array<uint32_t, 3>; // Size, support, duration
+
+	// SizeSupports[k] is the minimum support of the sets with k items (see FPGrowth), sets below it are not counted
+	PatternSpectrum(const ItemC& winLen, const bool withDuration, const std::vector<Support>& sizeSupports = {}) :
+		m_winLen(winLen),
+		m_withDuration(withDuration),
+		m_sizeSupports(sizeSupports),
+		m_counts(),
+		m_total(0)
+	{}
+
+	// Counts a set with len items, itemAt(i) returns the i-th item (not its id)
+	template<typename ItemAt>
+	void Add(const std::size_t& len, const Support& supp, ItemAt itemAt)
+	{
+		if (!m_sizeSupports.empty() && supp < m_sizeSupports[std::min(len, m_sizeSupports.size() - 1)]) return;
+
+		uint32_t duration = 0;
+
+		if (m_withDuration && len > 0)
+		{
+			ItemC lo = itemAt(0) % m_winLen;
+			ItemC hi = lo;
+
+			for (std::size_t i = 1; i < len; i++)
+			{
+				const ItemC lag = itemAt(i) % m_winLen;
+				lo              = std::min(lo, lag);
+				hi              = std::max(hi, lag);
+			}
+
+			duration = hi - lo;
+		}
+
+		m_counts[{ static_cast<uint32_t>(len), supp, duration }]++;
+		m_total++;
+	}
+
+	void Add(const PatternPair& set)
+	{
+		Add(set.first.size(), set.second, [&set](const std::size_t& i) { return static_cast<ItemC>(set.first[i]); });
+	}
+
+	// Counts per (size, support, duration) in ascending order, the duration is 0 without durations
+	const std::map<Key, uint64_t>& GetCounts() const
+	{
+		return m_counts;
+	}
+
+	const bool& WithDuration() const
+	{
+		return m_withDuration;
+	}
+
+	// Number of counted sets
+	const uint64_t& GetCount() const
+	{
+		return m_total;
+	}
+
+private:
+	ItemC m_winLen;
+	bool m_withDuration;
+	std::vector<Support> m_sizeSupports;
+	std::map<Key, uint64_t> m_counts;
+	uint64_t m_total;
+};
@@ -0,0 +1,223 @@
+/*
+ *  File: ResultCache.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+/*
+ * On-disk cache of closed results. An entry is keyed by a fingerprint of the
+ * encoded transaction database, the window length and the output parameters of
+ * the run. The closedness of a set does not depend on these parameters, hence,
+ * a query with tighter thresholds (higher supp, zmin and min_neu, lower max_c)
+ * is answered by filtering an entry of a looser run (see JobDetection).
+ *
+ * File name: <fingerprint>_w<winlen>_s<supp>_z<zmin>_n<min_neu>_c<max_c>.fpc
+ * File data: magic, set count, per set: length, support, items (all 64-bit)
+ */
+
+#pragma once
+
+#include "FPGrowth.h"
+#include "Logger.h"
+#include "Types.h"
+#include "Utils.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+class ResultCache
+{
+	DISABLE_COPY_ASSIGN_MOVE(ResultCache)
+
+	static constexpr uint64_t MAGIC     = 0x3143504746; // "FGPC1"
+	static constexpr const char* SUFFIX = ".fpc";
+
+public:
+	ResultCache(const std::string& dir) :
+		m_dir(dir)
+	{}
+
+	// FNV-1a hash of the transactions in their given order
+	static uint64_t Fingerprint(const Transactions& transactions)
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+
+		const auto add = [&hash](const uint64_t& val) {
+			for (std::size_t i = 0; i < sizeof(uint64_t); i++)
+			{
+				hash ^= (val >> (i * 8)) & 0xFF;
+				hash *= 0x100000001b3;
+			}
+		};
+
+		add(transactions.size());
+		for (const Transaction& trans : transactions)
+		{
+			add(trans.size());
+			for (const ItemC& item : trans)
+				add(item);
+		}
+
+		return hash;
+	}
+
+	// Loads the entry with the highest support among the ones with looser parameters than the given job,
+	// returns false if there is no such entry (or it cannot be read)
+	bool Load(const uint64_t& fingerprint, const ItemC& winLen, const Job& job, std::vector<PatternPair>& closed) const
+	{
+		std::error_code ec;
+		if (!std::filesystem::is_directory(m_dir, ec)) return false;
+
+		const std::string pre = prefix(fingerprint, winLen);
+		std::filesystem::path best;
+		Job bestJob;
+		bool found = false;
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(m_dir, ec))
+		{
+			Job cached;
+			if (!parseName(entry.path().filename().string(), pre, cached)) continue;
+
+			if (cached.minSupport > job.minSupport || cached.minPatternLen > job.minPatternLen || cached.minNeuronCount > job.minNeuronCount || cached.maxSupport < job.maxSupport) continue;
+
+			if (!found || cached.minSupport > bestJob.minSupport)
+			{
+				best    = entry.path();
+				bestJob = cached;
+				found   = true;
+			}
+		}
+
+		if (!found) return false;
+
+		std::ifstream file(best, std::ios::binary);
+		uint64_t magic = 0;
+		uint64_t cnt   = 0;
+
+		if (!read(file, magic) || magic != MAGIC || !read(file, cnt))
+		{
+			LOG_WARNING << "Invalid cache entry: " << best << std::endl;
+			return false;
+		}
+
+		closed.reserve(cnt);
+		for (uint64_t i = 0; i < cnt; i++)
+		{
+			uint64_t len  = 0;
+			uint64_t supp = 0;
+			if (!read(file, len) || !read(file, supp))
+			{
+				LOG_WARNING << "Truncated cache entry: " << best << std::endl;
+				closed.clear();
+				return false;
+			}
+
+			PatternPair pp;
+			pp.first.resize(len);
+			pp.second = static_cast<Support>(supp);
+
+			if (len > 0 && !file.read(reinterpret_cast<char*>(pp.first.data()), static_cast<std::streamsize>(len * sizeof(PatternType))))
+			{
+				LOG_WARNING << "Truncated cache entry: " << best << std::endl;
+				closed.clear();
+				return false;
+			}
+
+			closed.push_back(std::move(pp));
+		}
+
+		LOG_INFO << "Loaded " << closed.size() << " closed sets from the cache: " << best << std::endl;
+		return true;
+	}
+
+	// Stores the closed sets of a run, the file is written under a temporary name and renamed afterwards,
+	// i.e., concurrent runs never read a partial entry. Errors only result in a warning.
+	void Store(const uint64_t& fingerprint, const ItemC& winLen, const Job& job, const std::vector<PatternPair>& closed) const
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(m_dir, ec);
+
+		const std::filesystem::path path = std::filesystem::path(m_dir) / (prefix(fingerprint, winLen) + string_format("s%u_z%u_n%u_c%u", job.minSupport, job.minPatternLen, job.minNeuronCount, job.maxSupport) + SUFFIX);
+		const std::filesystem::path tmp  = path.string() + string_format(".%08x.tmp", std::random_device{}());
+
+		{
+			std::ofstream file(tmp, std::ios::binary);
+			write(file, MAGIC);
+			write(file, closed.size());
+
+			for (const PatternPair& pp : closed)
+			{
+				write(file, pp.first.size());
+				write(file, pp.second);
+				file.write(reinterpret_cast<const char*>(pp.first.data()), static_cast<std::streamsize>(pp.first.size() * sizeof(PatternType)));
+			}
+
+			if (!file)
+			{
+				LOG_WARNING << "Unable to write the cache entry: " << tmp << std::endl;
+				std::filesystem::remove(tmp, ec);
+				return;
+			}
+		}
+
+		std::filesystem::rename(tmp, path, ec);
+		if (ec)
+		{
+			LOG_WARNING << "Unable to store the cache entry: " << path << " (" << ec.message() << ")" << std::endl;
+			std::filesystem::remove(tmp, ec);
+		}
+	}
+
+private:
+	static std::string prefix(const uint64_t& fingerprint, const ItemC& winLen)
+	{
+		return string_format("%016llx_w%u_", static_cast<unsigned long long>(fingerprint), winLen);
+	}
+
+	static bool parseName(const std::string& name, const std::string& pre, Job& job)
+	{
+		if (name.compare(0, pre.size(), pre) != 0) return false;
+
+		char suffix[8] = { 0 };
+		if (std::sscanf(name.c_str() + pre.size(), "s%u_z%u_n%u_c%u%7s", &job.minSupport, &job.minPatternLen, &job.minNeuronCount, &job.maxSupport, suffix) != 5) return false;
+
+		return std::string(suffix) == SUFFIX;
+	}
+
+	static bool read(std::ifstream& file, uint64_t& val)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&val), sizeof(uint64_t)));
+	}
+
+	static void write(std::ofstream& file, const uint64_t& val)
+	{
+		file.write(reinterpret_cast<const char*>(&val), sizeof(uint64_t));
+	}
+
+private:
+	std::string m_dir;
+};
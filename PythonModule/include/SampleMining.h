@@ -0,0 +1,237 @@
+/*
+ *  File: SampleMining.h
+ *  Copyright (c) 2021 Florian Porrmann
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+/*
+ * Approximate mining on a random sample of the transactions: The sample is mined with
+ * the support scaled to its size and the supports of the sets are extrapolated to the
+ * whole database. The error bounds follow from the normal approximation of sampling
+ * without replacement. Optionally, the sets are verified on the whole database (as
+ * proposed by Toivonen), i.e., the sample is mined with a support lowered by the error
+ * bound and the exact supports of these candidates are counted using the tid-lists
+ * of their items.
+ */
+
+#pragma once
+
+#include "ClosedHash.h"
+#include "Types.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <experimental/vector>
+
+class TransactionSample
+{
+	DISABLE_COPY_ASSIGN_MOVE(TransactionSample)
+
+public:
+	// Draws round(fraction * n) of the transactions without replacement, the bounds hold with the given confidence
+	TransactionSample(const Transactions& transactions, const double& fraction, const uint32_t& seed, const double& confidence) :
+		m_total(transactions.size()),
+		m_size(std::min(transactions.size(), static_cast<std::size_t>(std::llround(fraction * static_cast<double>(transactions.size()))))),
+		m_z(normalQuantile(confidence)),
+		m_transactions()
+	{
+		std::vector<std::size_t> idx(m_total);
+		std::iota(std::begin(idx), std::end(idx), 0);
+
+		std::mt19937 gen(seed);
+		for (std::size_t i = 0; i < m_size; i++)
+		{
+			std::uniform_int_distribution<std::size_t> dist(i, m_total - 1);
+			std::swap(idx[i], idx[dist(gen)]);
+		}
+
+		m_transactions.reserve(m_size);
+		for (std::size_t i = 0; i < m_size; i++)
+			m_transactions.push_back(transactions[idx[i]]);
+	}
+
+	// The transactions of the sample, the tree build reduces them in place
+	Transactions& GetTransactions()
+	{
+		return m_transactions;
+	}
+
+	const std::size_t& GetSize() const
+	{
+		return m_size;
+	}
+
+	// Support of the sample that corresponds to the support of the whole database, if lowered
+	// a set with this support in the database is missed with a probability of (1 - confidence) / 2
+	Support ScaleSupport(const Support& minSupport, const bool lowered) const
+	{
+		if (m_total == 0) return minSupport;
+
+		double scaled = static_cast<double>(minSupport) * static_cast<double>(m_size) / static_cast<double>(m_total);
+		if (!lowered) return std::max<Support>(1, static_cast<Support>(std::ceil(scaled)));
+
+		scaled -= m_z * stdDev(static_cast<double>(minSupport) / static_cast<double>(m_total));
+		return std::max<Support>(1, static_cast<Support>(std::floor(scaled)));
+	}
+
+	// Support in the whole database of a set with the given support in the sample
+	Support Extrapolate(const Support& sampleSupp) const
+	{
+		if (m_size == 0) return 0;
+		return static_cast<Support>(std::llround(static_cast<double>(sampleSupp) * static_cast<double>(m_total) / static_cast<double>(m_size)));
+	}
+
+	// Half width of the confidence interval of an extrapolated support
+	Support Error(const Support& supp) const
+	{
+		if (m_size == 0 || m_total == 0) return 0;
+
+		const double p = std::min(1.0, static_cast<double>(supp) / static_cast<double>(m_total));
+		return static_cast<Support>(std::ceil(m_z * stdDev(p) * static_cast<double>(m_total) / static_cast<double>(m_size)));
+	}
+
+private:
+	// Standard deviation of the support in the sample of a set with the relative support p in the database
+	double stdDev(const double& p) const
+	{
+		if (m_total < 2) return 0;
+
+		const double fpc = static_cast<double>(m_total - m_size) / static_cast<double>(m_total - 1);
+		return std::sqrt(static_cast<double>(m_size) * p * (1.0 - p) * fpc);
+	}
+
+	// Two-sided quantile of the standard normal distribution (bisection on erfc)
+	static double normalQuantile(const double& confidence)
+	{
+		const double tail = (1.0 - confidence) / 2.0;
+		double lo = 0.0;
+		double hi = 10.0;
+
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			const double mid = (lo + hi) / 2.0;
+			if (0.5 * std::erfc(mid / std::sqrt(2.0)) > tail)
+				lo = mid;
+			else
+				hi = mid;
+		}
+
+		return (lo + hi) / 2.0;
+	}
+
+private:
+	std::size_t m_total;
+	std::size_t m_size;
+	double m_z;
+	Transactions m_transactions;
+};
+
+// Exact supports of arbitrary sets in a transaction database (vertical layout, Eclat-style)
+class SupportCounter
+{
+	DISABLE_COPY_ASSIGN_MOVE(SupportCounter)
+
+	using TidList = std::vector<uint32_t>;
+
+public:
+	explicit SupportCounter(const Transactions& transactions) :
+		m_tids()
+	{
+		for (std::size_t tid = 0; tid < transactions.size(); tid++)
+		{
+			for (const ItemC& item : transactions[tid])
+			{
+				TidList& tids = m_tids[item];
+				if (tids.empty() || tids.back() != tid)
+					tids.push_back(static_cast<uint32_t>(tid));
+			}
+		}
+	}
+
+	// Number of transactions containing all items, the lists are intersected starting with the shortest one
+	Support Count(const PatternVec& items) const
+	{
+		std::vector<const TidList*> lists;
+		for (const PatternType& item : items)
+		{
+			const auto it = m_tids.find(static_cast<ItemC>(item));
+			if (it == m_tids.end()) return 0;
+			lists.push_back(&it->second);
+		}
+
+		if (lists.empty()) return 0;
+
+		std::sort(std::begin(lists), std::end(lists), [](const TidList* pA, const TidList* pB) { return pA->size() < pB->size(); });
+
+		TidList cur(*lists.front());
+		TidList next;
+
+		for (std::size_t i = 1; i < lists.size() && !cur.empty(); i++)
+		{
+			next.clear();
+			std::set_intersection(std::begin(cur), std::end(cur), std::begin(*lists[i]), std::end(*lists[i]), std::back_inserter(next));
+			cur.swap(next);
+		}
+
+		return static_cast<Support>(cur.size());
+	}
+
+private:
+	std::unordered_map<ItemC, TidList> m_tids;
+};
+
+// Replaces the supports of the candidates (closed sets of the sample) by their exact supports in the database and
+// removes the sets below minSupport. A candidate with a superset of equal support is not closed in the database.
+void VerifyCandidates(std::vector<PatternPair>& candidates, const SupportCounter& counter, const Support& minSupport)
+{
+	for (PatternPair& pp : candidates)
+		pp.second = counter.Count(pp.first);
+
+	std::experimental::erase_if(candidates, [&minSupport](const PatternPair& pp) { return pp.second < minSupport; });
+
+	// A superset has more items, hence, the sets are checked in descending length
+	std::stable_sort(std::begin(candidates), std::end(candidates), [](const PatternPair& a, const PatternPair& b) { return a.first.size() > b.first.size(); });
+
+	ClosedHash closed;
+	std::vector<PatternPair> res;
+	std::vector<ItemID> items;
+
+	for (PatternPair& pp : candidates)
+	{
+		items.assign(std::begin(pp.first), std::end(pp.first));
+		std::sort(std::begin(items), std::end(items));
+
+		if (closed.HasSuperset(items.data(), items.size(), pp.second)) continue;
+
+		closed.Add(items.data(), items.size(), pp.second);
+		res.push_back(std::move(pp));
+	}
+
+	candidates = std::move(res);
+}
@@ -29,6 +29,7 @@
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <stdio.h>
 #include <string>
 #ifndef _WIN32
@@ -38,8 +39,12 @@
 
 #include <Python.h>
 
+#include "Checkpoint.h"
 #include "FPGrowth.h"
 #include "Logger.h"
+#include "PatternExpander.h"
+#include "ResultCache.h"
+#include "SampleMining.h"
 #include "SigTerm.h"
 #include "Utils.h"
 
@@ -115,9 +120,24 @@ DEFINE_EXCEPTION(ModuleException)
 // =========  Python Module Setup  ======== //
 
 PyObject* fpgrowth(PyObject* self, PyObject* args, PyObject* kwds);
+PyObject* fpgrowthJobs(PyObject* self, PyObject* args, PyObject* kwds);
+PyObject* fpgrowthBatch(PyObject* self, PyObject* args, PyObject* kwds);
+PyObject* fpgrowthSample(PyObject* self, PyObject* args, PyObject* kwds);
+PyObject* estimate(PyObject* self, PyObject* args, PyObject* kwds);
+PyObject* fptree(PyObject* self, PyObject* args, PyObject* kwds);
+PyObject* patternIterNext(PyObject* self);
+void patternIterDealloc(PyObject* self);
+PyObject* treeGrowth(PyObject* self, PyObject* args, PyObject* kwds);
+PyObject* treeAppend(PyObject* self, PyObject* args, PyObject* kwds);
+void treeDealloc(PyObject* self);
 
 static PyMethodDef ModuleFunctions[] = {
 	{ "fpgrowth", (PyCFunction)(void *)(PyCFunctionWithKeywords)fpgrowth, METH_VARARGS | METH_KEYWORDS, nullptr },
+	{ "fpgrowth_jobs", (PyCFunction)(void *)(PyCFunctionWithKeywords)fpgrowthJobs, METH_VARARGS | METH_KEYWORDS, nullptr },
+	{ "fpgrowth_batch", (PyCFunction)(void *)(PyCFunctionWithKeywords)fpgrowthBatch, METH_VARARGS | METH_KEYWORDS, nullptr },
+	{ "fpgrowth_sample", (PyCFunction)(void *)(PyCFunctionWithKeywords)fpgrowthSample, METH_VARARGS | METH_KEYWORDS, nullptr },
+	{ "estimate", (PyCFunction)(void *)(PyCFunctionWithKeywords)estimate, METH_VARARGS | METH_KEYWORDS, nullptr },
+	{ "fptree", (PyCFunction)(void *)(PyCFunctionWithKeywords)fptree, METH_VARARGS | METH_KEYWORDS, nullptr },
 	{ nullptr, nullptr, 0, nullptr }
 };
 
@@ -142,12 +162,80 @@ static struct PyModuleDef ModuleDefinitions = {
 #pragma GCC diagnostic pop
 #endif
 
+// Iterator over the lazily expanded itemsets of target 's'
+struct PatternIterObject
+{
+	PyObject_HEAD
+	PatternExpander* pExpander;
+	std::vector<PyObject*>* pItems; // Python object per item id (owned references)
+};
+
+static PyType_Slot PatternIterSlots[] = {
+	{ Py_tp_iter, (void*)PyObject_SelfIter },
+	{ Py_tp_iternext, (void*)patternIterNext },
+	{ Py_tp_dealloc, (void*)patternIterDealloc },
+	{ Py_tp_doc, (void*)"Iterator over the frequent itemsets, expanding the perfect extensions on demand" },
+	{ 0, nullptr }
+};
+
+static PyType_Spec PatternIterSpec = {
+	TO_STRING(MODULE_NAME) ".PatternIterator",
+	sizeof(PatternIterObject),
+	0,
+	Py_TPFLAGS_DEFAULT,
+	PatternIterSlots
+};
+
+static PyObject* pPatternIterType = nullptr;
+
+// Persistent database and tree for repeated growths with different parameters
+struct FPTreeObject
+{
+	PyObject_HEAD
+	FPGrowth* pFP;
+	std::map<Py_hash_t, PyObject*>* pHashMap; // Python object per item hash (owned references)
+};
+
+static PyMethodDef FPTreeMethods[] = {
+	{ "fpgrowth", (PyCFunction)(void *)(PyCFunctionWithKeywords)treeGrowth, METH_VARARGS | METH_KEYWORDS, "Runs a growth on the tree, takes the arguments of fpgrowth except the transactions and winlen" },
+	{ "append", (PyCFunction)(void *)(PyCFunctionWithKeywords)treeAppend, METH_VARARGS | METH_KEYWORDS, "Appends transactions to the tree, returns False (tree unchanged) if it has to be rebuilt from the whole database" },
+	{ nullptr, nullptr, 0, nullptr }
+};
+
+static PyType_Slot FPTreeSlots[] = {
+	{ Py_tp_methods, (void*)FPTreeMethods },
+	{ Py_tp_dealloc, (void*)treeDealloc },
+	{ Py_tp_doc, (void*)"Transaction database and FP-tree built once for repeated growths" },
+	{ 0, nullptr }
+};
+
+static PyType_Spec FPTreeSpec = {
+	TO_STRING(MODULE_NAME) ".FPTree",
+	sizeof(FPTreeObject),
+	0,
+	Py_TPFLAGS_DEFAULT,
+	FPTreeSlots
+};
+
+static PyObject* pFPTreeType = nullptr;
+
 PyMODINIT_FUNC INIT_FUNC_NAME(MODULE_NAME)(void)
 {
 	Py_Initialize();
 	PyObject* pModule = PyModule_Create(&ModuleDefinitions);
 	PyModule_AddObject(pModule, "version", Py_BuildValue("s", VERSION));
 	PyModule_AddObject(pModule, "__version__", Py_BuildValue("s", VERSION));
+
+	pPatternIterType = PyType_FromSpec(&PatternIterSpec);
+	if (!pPatternIterType) return nullptr;
+	Py_INCREF(pPatternIterType);
+	PyModule_AddObject(pModule, "PatternIterator", pPatternIterType);
+
+	pFPTreeType = PyType_FromSpec(&FPTreeSpec);
+	if (!pFPTreeType) return nullptr;
+	Py_INCREF(pFPTreeType);
+	PyModule_AddObject(pModule, "FPTree", pFPTreeType);
+
 	return pModule;
 }
 
@@ -184,72 +272,26 @@ void cleanupPyRefs(std::initializer_list<PyObject*> objs)
 		Py_DECREF(pObj);
 }
 
-// =========  Python Module Functions  ======== //
-
-static constexpr ItemC WIN_LEN = 20;
-
-PyObject* fpgrowth(PyObject* self, PyObject* args, PyObject* kwds)
+// Reads the transactions of an iterable of iterables, the items are replaced by their hash,
+// the hash map keeps the Python object of every item
+bool loadTransactions(PyObject* tracts, Transactions& transactions, std::map<Py_hash_t, PyObject*>& hashMap)
 {
-	UNUSED(self);
-	const char* ckwds[] = { "tracts", "target", "supp", "zmin", "zmax", "report", "algo", "winlen", "max_c", "min_neu", "verbose", "threads", nullptr };
-	PyObject* tracts;
-	char* target    = nullptr;
-	double supp     = 10;
-	Support support = 0;
-	uint32_t zmin   = 1;
-	uint32_t zmax   = 0;
-	uint32_t maxc   = static_cast<uint32_t>(~0);
-	uint32_t minneu = 1;
-	char* report    = nullptr;
-	char* algo      = nullptr;
-	uint32_t winlen = WIN_LEN;
-	int32_t verbose = ToUnderlying(Verbosity::VB_INFO);
-	int32_t threads = 1;
-	Verbosity verbosity;
-	Timer fullTimer;
-
-	std::map<Py_hash_t, PyObject*> hashMap;
-
-	fullTimer.Start();
-
-	// ===== Evaluate the Function Arguments ===== //
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sdIIssIIIII", const_cast<char**>(ckwds), &tracts, &target, &supp, &zmin, &zmax, &report, &algo, &winlen, &maxc, &minneu, &verbose, &threads))
-		return nullptr;
-
-	if (threads < -1) threads = -1;
-
-	support   = static_cast<Support>(std::abs(supp));
-	verbosity = ToVerbosity(verbose);
-
-	SetVerbosity(verbosity);
-
-	LOG_INFO << " =========  FPGrowth C++ Module (v" VERSION ") - Start" << "  ========= " << std::endl;
-	LOG_INFO << " - OS      : " << OS_STR << std::endl
-			 << " - ARCH    : " << ARCH_STR << std::endl
-			 << " - Compiler: " << COMPILER_STR << std::endl
-	         << " - PID     : " << GET_PID << std::endl;
-
-	sigInstall(); // Install signal handler to catch CTRL-C interrupts
-
-	// ========= Load Transaction Database from Python START ========= //
 	PyObject* pTractsItr = PyObject_GetIter(tracts);
 
 	if (!pTractsItr)
 	{
 		ERR_TYPE("transaction database must be iterable");
-		return nullptr;
+		return false;
 	}
 
 	PyObject* pTransItr;
 	PyObject* pItemItr;
 	PyObject* pItem;
-	Transactions transactions;
 
 	while ((pTransItr = PyIter_Next(pTractsItr)) != nullptr)
 	{
 #ifdef WITH_SIG_TERM
-		if (sigAborted())
-			EXIT_INTERRUPT();
+		if (sigAborted()) throw(FPGException("CTRL-C abort"));
 #endif
 
 		pItemItr = PyObject_GetIter(pTransItr);
@@ -259,15 +301,14 @@ PyObject* fpgrowth(PyObject* self, PyObject* args, PyObject* kwds)
 		{
 			cleanupPyRefs({ pTractsItr });
 			ERR_TYPE("transactions must be iterable");
-			return nullptr;
+			return false;
 		}
 
 		Transaction tc;
 		while ((pItem = PyIter_Next(pItemItr)) != nullptr)
 		{
 #ifdef WITH_SIG_TERM
-			if (sigAborted())
-				EXIT_INTERRUPT();
+			if (sigAborted()) throw(FPGException("CTRL-C abort"));
 #endif
 
 			Py_hash_t h = PyObject_Hash(pItem);
@@ -275,7 +316,7 @@ PyObject* fpgrowth(PyObject* self, PyObject* args, PyObject* kwds)
 			{
 				cleanupPyRefs({ pItem, pItemItr, pTractsItr });
 				ERR_TYPE("items must be hashable");
-				return nullptr;
+				return false;
 			}
 
 			hashMap.try_emplace(h, pItem);
@@ -291,63 +332,401 @@ PyObject* fpgrowth(PyObject* self, PyObject* args, PyObject* kwds)
 	}
 
 	cleanupPyRefs({ pTractsItr });
+	return true;
+}
 
-	// ========= Load Transaction Database from Python END ========= //
+// Sets a dict entry and releases the reference to the value
+void setDictItem(PyObject* pDict, const char* pKey, PyObject* pValue)
+{
+	if (!pValue) throw ModuleException("Unable to allocate memory for a dict value");
 
-	std::vector<PatternPair> closed;
+	const int res = PyDict_SetItemString(pDict, pKey, pValue);
+	Py_DECREF(pValue);
+
+	if (res != 0) throw ModuleException("Unable to add an entry to a dict");
+}
+
+// Converts the sets into a list of (pattern, support) tuples
+PyObject* createPatternList(const std::vector<PatternPair>& patterns, std::map<Py_hash_t, PyObject*>& hashMap)
+{
+	PyObject* pyList = createPyList(patterns.size());
+	PyObject* pyPatternWSupp;
+	PyObject* pyPattern;
+
+	for (auto [idx, pp] : enumerate(patterns))
+	{
+#ifdef WITH_SIG_TERM
+		if (sigAborted()) throw(FPGException("CTRL-C abort"));
+#endif
+
+		pyPatternWSupp = createPyTuple(2);
+		pyPattern      = createPyTuple(pp.first.size());
+
+		for (auto [i, item] : enumerate(pp.first))
+		{
+			PyObject* pItem = hashMap[static_cast<ItemC>(item)];
+			Py_INCREF(pItem);
+			PyTuple_SET_ITEM(pyPattern, i, pItem);
+		}
+
+		PyTuple_SET_ITEM(pyPatternWSupp, 0, pyPattern);              // Set Pattern
+		PyTuple_SET_ITEM(pyPatternWSupp, 1, long2PyLong(pp.second)); // Set Support
+
+		PyList_SET_ITEM(pyList, idx, pyPatternWSupp);
+	}
+
+	return pyList;
+}
+
+// =========  Pattern Iterator  ======== //
+
+PyObject* patternIterNext(PyObject* self)
+{
+	PatternIterObject* pIter = reinterpret_cast<PatternIterObject*>(self);
+	PatternVec items;
+	Support supp;
+
+	// Returning nullptr without an exception set ends the iteration
+	if (!pIter->pExpander || !pIter->pExpander->Next(items, supp)) return nullptr;
 
 	try
 	{
-		FPGrowth fp(transactions, support, zmin, zmax, static_cast<ItemC>(winlen), maxc, minneu, threads);
+		PyObject* pyPatternWSupp = createPyTuple(2);
+		PyObject* pyPattern      = createPyTuple(items.size());
+
+		for (auto [i, item] : enumerate(items))
+		{
+			PyObject* pItem = (*pIter->pItems)[item];
+			Py_INCREF(pItem);
+			PyTuple_SET_ITEM(pyPattern, i, pItem);
+		}
+
+		PyTuple_SET_ITEM(pyPatternWSupp, 0, pyPattern);
+		PyTuple_SET_ITEM(pyPatternWSupp, 1, long2PyLong(supp));
+
+		return pyPatternWSupp;
+	}
+	catch (const ModuleException& e)
+	{
+		PyErr_SetString(PyExc_MemoryError, e.what());
+		return nullptr;
+	}
+}
+
+void patternIterDealloc(PyObject* self)
+{
+	PatternIterObject* pIter = reinterpret_cast<PatternIterObject*>(self);
+	PyTypeObject* pType      = Py_TYPE(self);
+
+	delete pIter->pExpander;
+
+	if (pIter->pItems)
+	{
+		for (PyObject* pItem : *pIter->pItems)
+			Py_XDECREF(pItem);
+
+		delete pIter->pItems;
+	}
+
+	pType->tp_free(self);
+	Py_DECREF(pType);
+}
+
+// Takes the ownership of the expander, the Python object of every item id is referenced
+// by the iterator, as the transaction database can be released before the iteration ends
+PyObject* createPatternIter(PatternExpander* pExpander, const ItemC* pId2Item, const std::size_t& itemCount, std::map<Py_hash_t, PyObject*>& hashMap)
+{
+	PatternIterObject* pIter = PyObject_New(PatternIterObject, reinterpret_cast<PyTypeObject*>(pPatternIterType));
+	if (!pIter)
+	{
+		delete pExpander;
+		throw(ModuleException("Unable to allocate memory for the Python Pattern Iterator"));
+	}
+
+	pIter->pExpander = pExpander;
+	pIter->pItems    = new std::vector<PyObject*>(itemCount, nullptr);
+
+	for (std::size_t i = 0; i < itemCount; i++)
+	{
+		PyObject* pItem = hashMap[static_cast<ItemC>(pId2Item[i])];
+		Py_INCREF(pItem);
+		(*pIter->pItems)[i] = pItem;
+	}
+
+	return reinterpret_cast<PyObject*>(pIter);
+}
+
+// =========  Argument Parsing  ======== //
+
+// Target: 'c' - closed itemsets (default), 'm' - maximal itemsets, 's' - all frequent itemsets,
+// returned as iterator (expand=True) or list of (base, perfect extensions, support) (expand=False)
+bool parseTarget(const char* target, Target& growthTarget)
+{
+	if (target == nullptr) return true;
+
+	switch (target[0])
+	{
+		case 'c':
+			growthTarget = Target::TA_ALL;
+			return true;
+		case 'm':
+			growthTarget = Target::TA_MAXIMAL;
+			return true;
+		case 's':
+			growthTarget = Target::TA_COMPRESSED;
+			return true;
+		default:
+			PyErr_SetString(PyExc_ValueError, "invalid target (must be 'c', 'm' or 's')");
+			return false;
+	}
+}
+
+// Closed detection: 't' - prefix trees (default), 'h' - hash index, 'f' - flat prefix trees
+bool parseClosedAlgo(const char* cdalgo, ClosedAlgo& closedAlgo)
+{
+	if (cdalgo == nullptr) return true;
+
+	switch (cdalgo[0])
+	{
+		case 't':
+			closedAlgo = ClosedAlgo::CA_TREE;
+			return true;
+		case 'h':
+			closedAlgo = ClosedAlgo::CA_HASH;
+			return true;
+		case 'f':
+			closedAlgo = ClosedAlgo::CA_FLAT;
+			return true;
+		default:
+			PyErr_SetString(PyExc_ValueError, "invalid closed detection algorithm (must be 't', 'h' or 'f')");
+			return false;
+	}
+}
+
+// Pattern spectrum instead of the sets: '#' - counts per (size, support), '3d#' - counts per (size, support, duration)
+bool parseSpectrum(const char* spectrum, std::unique_ptr<PatternSpectrum>& pSpectrum, const ItemC& winLen, const std::vector<Support>& sizeSupports)
+{
+	if (spectrum == nullptr) return true;
+
+	const std::string type(spectrum);
+	if (type != "#" && type != "3d#")
+	{
+		PyErr_SetString(PyExc_ValueError, "invalid spectrum (must be '#' or '3d#')");
+		return false;
+	}
+
+	pSpectrum = std::make_unique<PatternSpectrum>(winLen, type == "3d#", sizeSupports);
+	return true;
+}
+
+// Minimum support per pattern size: {size: supp}, a value applies to all sizes up to the next given size,
+// smaller sizes use supp. All sizes are mined in a single run at the lowest of these supports.
+bool parseSizeSupports(PyObject* suppBySize, const Support& support, std::vector<Support>& sizeSupports)
+{
+	if (suppBySize == nullptr || suppBySize == Py_None) return true;
+
+	if (!PyDict_Check(suppBySize))
+	{
+		PyErr_SetString(PyExc_TypeError, "supp_by_size must be a dict {size: supp}");
+		return false;
+	}
+
+	std::map<std::size_t, Support> supps;
+	PyObject* pKey;
+	PyObject* pValue;
+	Py_ssize_t pos = 0;
+
+	while (PyDict_Next(suppBySize, &pos, &pKey, &pValue))
+	{
+		const long size   = PyLong_AsLong(pKey);
+		const double sVal = PyFloat_AsDouble(pValue);
+		if (PyErr_Occurred()) return false;
+
+		if (size < 0)
+		{
+			PyErr_SetString(PyExc_ValueError, "supp_by_size sizes must not be negative");
+			return false;
+		}
+
+		supps[static_cast<std::size_t>(size)] = static_cast<Support>(std::abs(sVal));
+	}
+
+	if (supps.empty()) return true;
+
+	sizeSupports.assign(supps.rbegin()->first + 1, support);
+	for (auto it = supps.begin(); it != supps.end(); it++)
+	{
+		const std::size_t end = (std::next(it) == supps.end()) ? sizeSupports.size() : std::next(it)->first;
+		std::fill(sizeSupports.begin() + it->first, sizeSupports.begin() + end, it->second);
+	}
+
+	return true;
+}
+
+// =========  Growth and Result Conversion  ======== //
+
+// Runs the growth of the target on the tree, the closed and maximal sets are written to closed (or only counted by
+// the spectrum if given), the compressed records are kept by the expander. With topK > 0 only the closed sets with
+// the k highest supports are kept (pipelined, the support of the growth is raised while the sets are found).
+// Returns false if the growth did not provide any result.
+bool runGrowth(FPGrowth& fp, const Target& growthTarget, const ClosedAlgo& closedAlgo, const bool pipelined, std::vector<PatternPair>& closed, std::unique_ptr<PatternExpander>& pExpander, PatternSpectrum* pSpectrum = nullptr, const std::size_t topK = 0)
+{
+	std::unique_ptr<TopKSupport> pTopK = (topK > 0) ? std::make_unique<TopKSupport>(fp, topK) : nullptr;
+	const PatternOutput out            = pSpectrum ? PatternOutput(*pSpectrum) : PatternOutput(closed, pTopK.get());
+
+	if (pTopK)
+	{
+		if (!PipelinedClosedDetection(fp, out, closedAlgo)) return false;
+
+		// Sets found before the support reached its final value
+		const Support threshold = pTopK->GetThreshold();
+		std::experimental::erase_if(closed, [&threshold](const PatternPair& pp) { return pp.second < threshold; });
+		LOG_INFO << "Top-" << topK << " Pattern: " << closed.size() << " (Support >= " << threshold << ")" << std::endl;
+		return true;
+	}
+
+	if (growthTarget == Target::TA_COMPRESSED)
+	{
+		pExpander = std::make_unique<PatternExpander>(fp);
+		return CompressedGrowth(fp, *pExpander, pipelined);
+	}
+
+	if (pipelined)
+	{
+		if (growthTarget == Target::TA_MAXIMAL)
+		{
+			if (!PipelinedMaximalDetection(fp, out)) return false;
+		}
+		else if (!PipelinedClosedDetection(fp, out, closedAlgo))
+			return false;
+	}
+	else
+	{
 		const Pattern* pPattern = fp.Growth();
-		if (pPattern == nullptr) Py_RETURN_NONE;
+		if (pPattern == nullptr) return false;
 		LOG_INFO_EVAL << "Memory Usage after FPGrowth: " << GetMemString() << std::endl;
 
-		ClosedDetection(fp, pPattern, closed);
-		LOG_INFO_EVAL << "Memory Usage after Closed Detection: " << GetMemString() << std::endl;
+		if (growthTarget == Target::TA_MAXIMAL)
+			MaximalDetection(fp, pPattern, out);
+		else
+			ClosedDetection(fp, pPattern, out, closedAlgo);
 	}
-	catch (const FPGException&)
+
+	// The growth runs at the lowest size support, the sets of sizes with a higher support are dropped
+	if (fp.GetSizeSupports().size() > 1)
+		std::experimental::erase_if(closed, [&fp](const PatternPair& pp) { return !fp.AcceptSizeSupport(pp.first.size(), pp.second); });
+
+	LOG_INFO_EVAL << "Memory Usage after Closed Detection: " << GetMemString() << std::endl;
+	return true;
+}
+
+// Converts the spectrum into a list of (size, support, count) or (size, support, duration, count) tuples
+PyObject* createSpectrumList(const PatternSpectrum& spectrum)
+{
+	PyObject* pyList = createPyList(spectrum.GetCounts().size());
+	std::size_t idx  = 0;
+
+	for (const auto& [key, cnt] : spectrum.GetCounts())
 	{
-		EXIT_INTERRUPT();
+		PyObject* pyRow = createPyTuple(spectrum.WithDuration() ? 4 : 3);
+		std::size_t col = 0;
+
+		PyTuple_SET_ITEM(pyRow, col++, long2PyLong(static_cast<long>(key[0])));
+		PyTuple_SET_ITEM(pyRow, col++, long2PyLong(static_cast<long>(key[1])));
+		if (spectrum.WithDuration())
+			PyTuple_SET_ITEM(pyRow, col++, long2PyLong(static_cast<long>(key[2])));
+		PyTuple_SET_ITEM(pyRow, col++, long2PyLong(static_cast<long>(cnt)));
+
+		PyList_SET_ITEM(pyList, idx++, pyRow);
 	}
 
-	LOG_INFO_EVAL << "Converting Pattern to Python List ... " << std::flush;
-	Timer t;
-	t.Start();
+	return pyList;
+}
 
+// Python result of a spectrum run, removes the signal handler
+PyObject* createSpectrum(const PatternSpectrum& spectrum, Timer& fullTimer)
+{
 	try
 	{
-		PyObject* pyList = createPyList(closed.size());
-		PyObject* pyPatternWSupp;
-		PyObject* pyPattern;
+		PyObject* pyList = createSpectrumList(spectrum);
 
-		for (auto [idx, pp] : enumerate(closed))
-		{
-#ifdef WITH_SIG_TERM
-			if (sigAborted())
-				EXIT_INTERRUPT();
-#endif
+		fullTimer.Stop();
+		LOG_INFO_EVAL << " =========  FPGrowth C++ Module End (" << fullTimer << ")  ========= " << std::endl;
 
-			pyPatternWSupp = createPyTuple(2);
-			pyPattern      = createPyTuple(pp.first.size());
+		sigRemove();
+		return pyList;
+	}
+	catch (const ModuleException& e)
+	{
+		ERR_MEM(e.what())
+		return nullptr;
+	}
+}
 
-			for (auto [i, item] : enumerate(pp.first))
+// Converts the result of runGrowth into the Python result (list or iterator), removes the signal handler
+PyObject* createResult(const std::vector<PatternPair>& closed, std::unique_ptr<PatternExpander>& pExpander, const bool expand, std::map<Py_hash_t, PyObject*>& hashMap, Timer& fullTimer)
+{
+	if (pExpander)
+	{
+		try
+		{
+			if (expand)
 			{
-#ifdef WITH_SIG_TERM
-				if (sigAborted())
-					EXIT_INTERRUPT();
-#endif
+				const std::vector<ItemC>& id2Item = pExpander->GetId2Item();
+				PyObject* pyIter                  = createPatternIter(pExpander.release(), id2Item.data(), id2Item.size(), hashMap);
 
-				pItem = hashMap[static_cast<ItemC>(item)];
-				Py_INCREF(pItem);
-				PyTuple_SET_ITEM(pyPattern, i, pItem);
+				sigRemove();
+				return pyIter;
 			}
 
-			PyTuple_SET_ITEM(pyPatternWSupp, 0, pyPattern);              // Set Pattern
-			PyTuple_SET_ITEM(pyPatternWSupp, 1, long2PyLong(pp.second)); // Set Support
-
-			PyList_SET_ITEM(pyList, idx, pyPatternWSupp);
+			LOG_INFO_EVAL << "Converting Compressed Pattern to Python List ... " << std::flush;
+			Timer t;
+			t.Start();
+
+			PyObject* pyList = createPyList(pExpander->GetRecordCount());
+			std::size_t idx  = 0;
+			const ItemC* pId2Item = pExpander->GetId2Item().data();
+
+			const auto toTuple = [&hashMap, &pId2Item](const PatternVec& items) {
+				PyObject* pyTuple = createPyTuple(items.size());
+				for (auto [i, item] : enumerate(items))
+				{
+					PyObject* pItem = hashMap[static_cast<ItemC>(pId2Item[item])];
+					Py_INCREF(pItem);
+					PyTuple_SET_ITEM(pyTuple, i, pItem);
+				}
+				return pyTuple;
+			};
+
+			// (base items, perfect extensions, support)
+			pExpander->ForEachRecord([&](const PatternVec& base, const PatternVec& ext, const Support& s) {
+				PyObject* pyRecord = createPyTuple(3);
+				PyTuple_SET_ITEM(pyRecord, 0, toTuple(base));
+				PyTuple_SET_ITEM(pyRecord, 1, toTuple(ext));
+				PyTuple_SET_ITEM(pyRecord, 2, long2PyLong(s));
+				PyList_SET_ITEM(pyList, idx++, pyRecord);
+			});
+
+			t.Stop();
+			LOG_INFO_EVAL << "Done after: " << t << std::endl;
+
+			sigRemove();
+			return pyList;
+		}
+		catch (const ModuleException& e)
+		{
+			ERR_MEM(e.what())
+			return nullptr;
 		}
+	}
+
+	LOG_INFO_EVAL << "Converting Pattern to Python List ... " << std::flush;
+	Timer t;
+	t.Start();
+
+	try
+	{
+		PyObject* pyList = createPatternList(closed, hashMap);
 
 		t.Stop();
 		LOG_INFO_EVAL << "Done after: " << t << std::endl;
@@ -359,9 +738,1149 @@ PyObject* fpgrowth(PyObject* self, PyObject* args, PyObject* kwds)
 		sigRemove();
 		return pyList;
 	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
 	catch (const ModuleException& e)
 	{
 		ERR_MEM(e.what())
 		return nullptr;
 	}
 }
+
+// Result of a growth with a budget: (result, completed top-level items), takes the reference to the result
+PyObject* createAnytimeResult(PyObject* pyRes, const std::vector<ItemC>& completed, std::map<Py_hash_t, PyObject*>& hashMap)
+{
+	PyObject* pyItems = nullptr;
+
+	try
+	{
+		pyItems = createPyList(completed.size());
+		for (auto [i, item] : enumerate(completed))
+		{
+			PyObject* pItem = hashMap[static_cast<ItemC>(item)];
+			Py_INCREF(pItem);
+			PyList_SET_ITEM(pyItems, i, pItem);
+		}
+
+		PyObject* pyTuple = createPyTuple(2);
+		PyTuple_SET_ITEM(pyTuple, 0, pyRes);
+		PyTuple_SET_ITEM(pyTuple, 1, pyItems);
+		return pyTuple;
+	}
+	catch (const ModuleException& e)
+	{
+		Py_DECREF(pyRes);
+		Py_XDECREF(pyItems);
+		PyErr_SetString(PyExc_MemoryError, e.what());
+		return nullptr;
+	}
+}
+
+// =========  Python Module Functions  ======== //
+
+static constexpr ItemC WIN_LEN = 20;
+
+PyObject* fpgrowth(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	UNUSED(self);
+	const char* ckwds[] = { "tracts", "target", "supp", "zmin", "zmax", "report", "algo", "winlen", "max_c", "min_neu", "verbose", "threads", "pipelined", "cdalgo", "expand", "max_duration", "supp_by_size", "cache", "spectrum", "topk", "time_budget", "mem_budget", "checkpoint", "checkpoint_interval", nullptr };
+	PyObject* tracts;
+	char* target    = nullptr;
+	double supp     = 10;
+	Support support = 0;
+	uint32_t zmin   = 1;
+	uint32_t zmax   = 0;
+	uint32_t maxc   = static_cast<uint32_t>(~0);
+	uint32_t minneu = 1;
+	char* report    = nullptr;
+	char* algo      = nullptr;
+	uint32_t winlen = WIN_LEN;
+	int32_t verbose = ToUnderlying(Verbosity::VB_INFO);
+	int32_t threads = 1;
+	int pipelined   = 1;
+	char* cdalgo    = nullptr;
+	int expand      = 1;
+	int32_t maxdur  = -1;
+	PyObject* suppBySize = nullptr;
+	char* cache     = nullptr;
+	char* spectrum  = nullptr;
+	uint32_t topk   = 0;
+	double timeBudget   = 0;
+	uint64_t memBudget  = 0;
+	char* checkpoint    = nullptr;
+	double ckptInterval = 60;
+	ClosedAlgo closedAlgo = ClosedAlgo::CA_TREE;
+	Target growthTarget   = Target::TA_ALL;
+	Verbosity verbosity;
+	Timer fullTimer;
+
+	std::map<Py_hash_t, PyObject*> hashMap;
+
+	fullTimer.Start();
+
+	// ===== Evaluate the Function Arguments ===== //
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sdIIssIIIIIpspiOzzIdKzd", const_cast<char**>(ckwds), &tracts, &target, &supp, &zmin, &zmax, &report, &algo, &winlen, &maxc, &minneu, &verbose, &threads, &pipelined, &cdalgo, &expand, &maxdur, &suppBySize, &cache, &spectrum, &topk, &timeBudget, &memBudget, &checkpoint, &ckptInterval))
+		return nullptr;
+
+	if (!parseTarget(target, growthTarget) || !parseClosedAlgo(cdalgo, closedAlgo)) return nullptr;
+
+	if (threads < -1) threads = -1;
+
+	// Maximal duration (max. lag - min. lag) of the itemsets, negative values disable the limit
+	const uint32_t maxDuration = (maxdur < 0) ? static_cast<uint32_t>(~0) : static_cast<uint32_t>(maxdur);
+
+	support   = static_cast<Support>(std::abs(supp));
+	verbosity = ToVerbosity(verbose);
+
+	std::vector<Support> sizeSupports;
+	if (!parseSizeSupports(suppBySize, support, sizeSupports)) return nullptr;
+
+	std::unique_ptr<PatternSpectrum> pSpectrum;
+	if (!parseSpectrum(spectrum, pSpectrum, static_cast<ItemC>(winlen), sizeSupports)) return nullptr;
+
+	if (pSpectrum && growthTarget == Target::TA_COMPRESSED)
+	{
+		PyErr_SetString(PyExc_ValueError, "the spectrum requires target 'c' or 'm'");
+		return nullptr;
+	}
+
+	// Top-k: the closed sets with the k highest supports (and at least supp), the support is raised during the growth
+	if (topk > 0 && (growthTarget != Target::TA_ALL || pSpectrum || !sizeSupports.empty()))
+	{
+		PyErr_SetString(PyExc_ValueError, "topk requires target 'c' and can not be combined with spectrum or supp_by_size");
+		return nullptr;
+	}
+
+	// The buckets of a top-k growth depend on the support raised by the items mined before
+	if (checkpoint && topk > 0)
+	{
+		PyErr_SetString(PyExc_ValueError, "checkpoint can not be combined with topk");
+		return nullptr;
+	}
+
+	SetVerbosity(verbosity);
+
+	LOG_INFO << " =========  FPGrowth C++ Module (v" VERSION ") - Start" << "  ========= " << std::endl;
+	LOG_INFO << " - OS      : " << OS_STR << std::endl
+			 << " - ARCH    : " << ARCH_STR << std::endl
+			 << " - Compiler: " << COMPILER_STR << std::endl
+	         << " - PID     : " << GET_PID << std::endl;
+
+	sigInstall(); // Install signal handler to catch CTRL-C interrupts
+
+	// ========= Load Transaction Database from Python START ========= //
+	Transactions transactions;
+
+	try
+	{
+		if (!loadTransactions(tracts, transactions, hashMap)) return nullptr;
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	// ========= Load Transaction Database from Python END ========= //
+
+	std::vector<PatternPair> closed;
+	std::unique_ptr<PatternExpander> pExpander;
+
+	// The cache holds closed sets of all lengths, closed queries with zmax and the constraints that are
+	// pushed into the growth (max_duration, supp_by_size) are always mined
+	const Job job = { support, zmin, zmax, minneu, maxc };
+	const bool budget = timeBudget > 0 || memBudget > 0;
+	const bool cached = cache != nullptr && maxdur < 0 && sizeSupports.empty() && topk == 0 && !budget && (growthTarget == Target::TA_MAXIMAL || (growthTarget == Target::TA_ALL && zmax == 0));
+	std::unique_ptr<ResultCache> pCache;
+	uint64_t fingerprint = 0;
+
+	if (cached)
+	{
+		pCache      = std::make_unique<ResultCache>(cache);
+		fingerprint = ResultCache::Fingerprint(transactions);
+
+		std::vector<PatternPair> entry;
+		if (pCache->Load(fingerprint, static_cast<ItemC>(winlen), job, entry))
+		{
+			try
+			{
+				JobDetection(entry, job, static_cast<ItemC>(winlen), growthTarget, closed);
+			}
+			catch (const FPGException&)
+			{
+				EXIT_INTERRUPT();
+			}
+
+			if (pSpectrum)
+			{
+				for (const PatternPair& set : closed)
+					pSpectrum->Add(set);
+
+				return createSpectrum(*pSpectrum, fullTimer);
+			}
+
+			return createResult(closed, pExpander, expand, hashMap, fullTimer);
+		}
+	}
+
+	std::vector<ItemC> completed;
+
+	// The completed buckets are checkpointed, a checkpoint of the same run restores the tree and skips these items
+	std::unique_ptr<Checkpoint> pCheckpoint;
+	if (checkpoint)
+	{
+		uint64_t sizeKey = 0;
+		for (const Support& sizeSupp : sizeSupports)
+			sizeKey = sizeKey * 0x100000001b3 + sizeSupp;
+
+		pCheckpoint = std::make_unique<Checkpoint>(checkpoint, Checkpoint::Key(transactions, { winlen, support, zmin, zmax, maxc, minneu, static_cast<uint64_t>(growthTarget), maxDuration, sizeKey }), ckptInterval);
+	}
+
+	try
+	{
+		std::unique_ptr<FPGrowth> pFP;
+		bool resumed = false;
+
+		if (pCheckpoint && pCheckpoint->CanResume())
+		{
+			Transactions empty;
+			pFP     = std::make_unique<FPGrowth>(empty, support, zmin, zmax, static_cast<ItemC>(winlen), maxc, minneu, threads, growthTarget, maxDuration, sizeSupports);
+			resumed = pCheckpoint->Load(*pFP);
+		}
+
+		// The cache requires the sets, these are counted afterwards
+		if (!resumed)
+			pFP = std::make_unique<FPGrowth>(transactions, support, zmin, zmax, static_cast<ItemC>(winlen), maxc, minneu, threads, growthTarget, maxDuration, sizeSupports);
+
+		FPGrowth& fp = *pFP;
+
+		if (pCheckpoint)
+		{
+			pCheckpoint->Open(fp, resumed);
+			fp.SetBucketWriter([&pCheckpoint](const std::size_t& i, const Pattern& bucket) { pCheckpoint->Write(i, bucket); });
+		}
+
+		// The time budget includes loading the transactions and building the tree
+		if (budget)
+			fp.SetBudget((timeBudget > 0) ? std::max(timeBudget - fullTimer.GetElapsedTimeInSec(), 1e-9) : 0, memBudget);
+
+		if (!runGrowth(fp, growthTarget, closedAlgo, pipelined, closed, pExpander, cached ? nullptr : pSpectrum.get(), topk)) Py_RETURN_NONE;
+
+		if (budget)
+		{
+			completed = fp.GetCompletedItems();
+			if (fp.BudgetExceeded())
+				LOG_INFO << "Budget exceeded: " << completed.size() << " / " << fp.GetItemCount() << " top-level items completed" << std::endl;
+		}
+
+		// A partial run (budget) keeps its checkpoint to be resumed
+		if (pCheckpoint && !fp.BudgetExceeded())
+			pCheckpoint->Remove();
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	// Only the closed sets can answer later queries
+	if (cached && growthTarget == Target::TA_ALL)
+		pCache->Store(fingerprint, static_cast<ItemC>(winlen), job, closed);
+
+	PyObject* pyRes;
+
+	if (pSpectrum)
+	{
+		for (const PatternPair& set : closed)
+			pSpectrum->Add(set);
+
+		pyRes = createSpectrum(*pSpectrum, fullTimer);
+	}
+	else
+		pyRes = createResult(closed, pExpander, expand, hashMap, fullTimer);
+
+	if (!budget || !pyRes) return pyRes;
+
+	return createAnytimeResult(pyRes, completed, hashMap);
+}
+
+// Reads a job given as dict with the keys of fpgrowth (supp, zmin, zmax, min_neu, max_c), missing keys use the defaults
+bool parseJob(PyObject* pJob, Job& job)
+{
+	if (!PyDict_Check(pJob))
+	{
+		PyErr_SetString(PyExc_TypeError, "jobs must be dicts with the keys 'supp', 'zmin', 'zmax', 'min_neu' and 'max_c'");
+		return false;
+	}
+
+	const auto getUInt = [&pJob](const char* pKey, uint32_t& val) {
+		PyObject* pVal = PyDict_GetItemString(pJob, pKey);
+		if (pVal == nullptr) return true;
+
+		const unsigned long v = PyLong_AsUnsignedLong(pVal);
+		if (PyErr_Occurred()) return false;
+
+		val = static_cast<uint32_t>(v);
+		return true;
+	};
+
+	PyObject* pSupp = PyDict_GetItemString(pJob, "supp");
+	if (pSupp != nullptr)
+	{
+		const double supp = PyFloat_AsDouble(pSupp);
+		if (PyErr_Occurred()) return false;
+
+		job.minSupport = static_cast<Support>(std::abs(supp));
+	}
+
+	return getUInt("zmin", job.minPatternLen) && getUInt("zmax", job.maxPatternLen) && getUInt("min_neu", job.minNeuronCount) && getUInt("max_c", job.maxSupport);
+}
+
+// Runs several jobs on the same transactions: The database and the tree are only built once with the loosest
+// parameters of all jobs and a single closed growth provides the sets of all jobs. Returns one list of
+// (pattern, support) tuples per job. Target: 'c' - closed itemsets (default), 'm' - maximal itemsets
+PyObject* fpgrowthJobs(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	UNUSED(self);
+	const char* ckwds[] = { "tracts", "jobs", "target", "winlen", "verbose", "threads", "pipelined", "cdalgo", nullptr };
+	PyObject* tracts;
+	PyObject* pyJobs;
+	char* target    = nullptr;
+	uint32_t winlen = WIN_LEN;
+	int32_t verbose = ToUnderlying(Verbosity::VB_INFO);
+	int32_t threads = 1;
+	int pipelined   = 1;
+	char* cdalgo    = nullptr;
+	ClosedAlgo closedAlgo = ClosedAlgo::CA_TREE;
+	Target jobTarget      = Target::TA_ALL;
+	Timer fullTimer;
+
+	std::map<Py_hash_t, PyObject*> hashMap;
+
+	fullTimer.Start();
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|sIiips", const_cast<char**>(ckwds), &tracts, &pyJobs, &target, &winlen, &verbose, &threads, &pipelined, &cdalgo))
+		return nullptr;
+
+	if (target != nullptr)
+	{
+		if (target[0] == 'm')
+			jobTarget = Target::TA_MAXIMAL;
+		else if (target[0] != 'c')
+		{
+			PyErr_SetString(PyExc_ValueError, "invalid target (must be 'c' or 'm')");
+			return nullptr;
+		}
+	}
+
+	if (!parseClosedAlgo(cdalgo, closedAlgo)) return nullptr;
+
+	if (threads < -1) threads = -1;
+
+	std::vector<Job> jobs;
+	PyObject* pJobsItr = PyObject_GetIter(pyJobs);
+	if (!pJobsItr)
+	{
+		PyErr_SetString(PyExc_TypeError, "jobs must be iterable");
+		return nullptr;
+	}
+
+	PyObject* pJob;
+	while ((pJob = PyIter_Next(pJobsItr)) != nullptr)
+	{
+		Job job;
+		const bool valid = parseJob(pJob, job);
+		cleanupPyRefs({ pJob });
+
+		if (!valid)
+		{
+			cleanupPyRefs({ pJobsItr });
+			return nullptr;
+		}
+
+		jobs.push_back(job);
+	}
+
+	cleanupPyRefs({ pJobsItr });
+
+	if (jobs.empty())
+	{
+		PyErr_SetString(PyExc_ValueError, "at least one job is required");
+		return nullptr;
+	}
+
+	// Loosest parameters of all jobs, the maximal sets require the closed sets of all lengths
+	Job loosest = jobs.front();
+	for (const Job& job : jobs)
+	{
+		loosest.minSupport     = std::min(loosest.minSupport, job.minSupport);
+		loosest.minPatternLen  = std::min(loosest.minPatternLen, job.minPatternLen);
+		loosest.minNeuronCount = std::min(loosest.minNeuronCount, job.minNeuronCount);
+		loosest.maxSupport     = std::max(loosest.maxSupport, job.maxSupport);
+		loosest.maxPatternLen  = (loosest.maxPatternLen == 0 || job.maxPatternLen == 0) ? 0 : std::max(loosest.maxPatternLen, job.maxPatternLen);
+	}
+
+	if (jobTarget == Target::TA_MAXIMAL)
+		loosest.maxPatternLen = 0;
+
+	SetVerbosity(ToVerbosity(verbose));
+
+	LOG_INFO << " =========  FPGrowth C++ Module (v" VERSION ") - Start (" << jobs.size() << " Jobs)" << "  ========= " << std::endl;
+
+	sigInstall(); // Install signal handler to catch CTRL-C interrupts
+
+	Transactions transactions;
+	std::vector<PatternPair> closed;
+
+	try
+	{
+		if (!loadTransactions(tracts, transactions, hashMap)) return nullptr;
+
+		FPGrowth fp(transactions, loosest.minSupport, loosest.minPatternLen, loosest.maxPatternLen, static_cast<ItemC>(winlen), loosest.maxSupport, loosest.minNeuronCount, threads, Target::TA_ALL);
+
+		if (pipelined)
+		{
+			if (!PipelinedClosedDetection(fp, closed, closedAlgo)) Py_RETURN_NONE;
+		}
+		else
+		{
+			const Pattern* pPattern = fp.Growth();
+			if (pPattern == nullptr) Py_RETURN_NONE;
+
+			ClosedDetection(fp, pPattern, closed, closedAlgo);
+		}
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	LOG_INFO_EVAL << "Selecting the Pattern of the Jobs ... " << std::flush;
+	Timer t;
+	t.Start();
+
+	try
+	{
+		PyObject* pyList = createPyList(jobs.size());
+
+		for (auto [idx, job] : enumerate(jobs))
+		{
+			std::vector<PatternPair> res;
+			JobDetection(closed, job, static_cast<ItemC>(winlen), jobTarget, res);
+			PyList_SET_ITEM(pyList, idx, createPatternList(res, hashMap));
+		}
+
+		t.Stop();
+		LOG_INFO_EVAL << "Done after: " << t << std::endl;
+
+		fullTimer.Stop();
+		LOG_INFO_EVAL << " =========  FPGrowth C++ Module End (" << fullTimer << ")  ========= " << std::endl;
+
+		sigRemove();
+		return pyList;
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+	catch (const ModuleException& e)
+	{
+		ERR_MEM(e.what())
+		return nullptr;
+	}
+}
+
+// Mines several datasets (e.g., surrogates for a significance test) with the same parameters and returns one list
+// of (pattern, support) tuples (or the pattern spectrum, see fpgrowth) per dataset. Datasets that are large compared to the others (more than the share
+// of one thread of all item occurrences) are mined one after the other with all threads, the remaining ones in
+// parallel with one thread each. Target: 'c' - closed itemsets (default), 'm' - maximal itemsets
+PyObject* fpgrowthBatch(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	UNUSED(self);
+	const char* ckwds[] = { "datasets", "target", "supp", "zmin", "zmax", "winlen", "max_c", "min_neu", "verbose", "threads", "cdalgo", "max_duration", "supp_by_size", "spectrum", nullptr };
+	PyObject* datasets;
+	char* target    = nullptr;
+	double supp     = 10;
+	uint32_t zmin   = 1;
+	uint32_t zmax   = 0;
+	uint32_t winlen = WIN_LEN;
+	uint32_t maxc   = static_cast<uint32_t>(~0);
+	uint32_t minneu = 1;
+	int32_t verbose = ToUnderlying(Verbosity::VB_INFO);
+	int32_t threads = 0;
+	char* cdalgo    = nullptr;
+	int32_t maxdur  = -1;
+	PyObject* suppBySize = nullptr;
+	char* spectrum  = nullptr;
+	ClosedAlgo closedAlgo = ClosedAlgo::CA_TREE;
+	Target growthTarget   = Target::TA_ALL;
+	Timer fullTimer;
+
+	std::map<Py_hash_t, PyObject*> hashMap;
+
+	fullTimer.Start();
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sdIIIIIiisiOz", const_cast<char**>(ckwds), &datasets, &target, &supp, &zmin, &zmax, &winlen, &maxc, &minneu, &verbose, &threads, &cdalgo, &maxdur, &suppBySize, &spectrum))
+		return nullptr;
+
+	if (!parseTarget(target, growthTarget) || !parseClosedAlgo(cdalgo, closedAlgo)) return nullptr;
+
+	if (growthTarget == Target::TA_COMPRESSED)
+	{
+		PyErr_SetString(PyExc_ValueError, "invalid target (must be 'c' or 'm')");
+		return nullptr;
+	}
+
+	const Support support      = static_cast<Support>(std::abs(supp));
+	const uint32_t maxDuration = (maxdur < 0) ? static_cast<uint32_t>(~0) : static_cast<uint32_t>(maxdur);
+
+	std::vector<Support> sizeSupports;
+	if (!parseSizeSupports(suppBySize, support, sizeSupports)) return nullptr;
+
+	std::unique_ptr<PatternSpectrum> pSpectrum;
+	if (!parseSpectrum(spectrum, pSpectrum, static_cast<ItemC>(winlen), sizeSupports)) return nullptr;
+
+	SetVerbosity(ToVerbosity(verbose));
+
+	sigInstall(); // Install signal handler to catch CTRL-C interrupts
+
+	std::vector<Transactions> dbs;
+
+	try
+	{
+		PyObject* pDataItr = PyObject_GetIter(datasets);
+		if (!pDataItr)
+		{
+			ERR_TYPE("datasets must be iterable");
+			return nullptr;
+		}
+
+		PyObject* pData;
+		while ((pData = PyIter_Next(pDataItr)) != nullptr)
+		{
+			dbs.emplace_back();
+			const bool loaded = loadTransactions(pData, dbs.back(), hashMap);
+			cleanupPyRefs({ pData });
+
+			if (!loaded)
+			{
+				cleanupPyRefs({ pDataItr });
+				return nullptr;
+			}
+		}
+
+		cleanupPyRefs({ pDataItr });
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	int32_t poolSize = 1;
+#ifdef USE_OPENMP
+	if (threads == 0)
+		poolSize = omp_get_num_procs();
+	else if (threads > 1)
+		poolSize = threads;
+#endif
+
+	LOG_INFO << " =========  FPGrowth C++ Module (v" VERSION ") - Start (" << dbs.size() << " Datasets, " << poolSize << " Threads)" << "  ========= " << std::endl;
+
+	// Largest datasets first for the load balancing
+	std::vector<std::size_t> sizes(dbs.size(), 0);
+	std::vector<std::size_t> order(dbs.size());
+	std::size_t total = 0;
+
+	for (std::size_t idx = 0; idx < dbs.size(); idx++)
+	{
+		for (const Transaction& t : dbs[idx])
+			sizes[idx] += t.size();
+
+		order[idx] = idx;
+		total += sizes[idx];
+	}
+
+	std::sort(std::begin(order), std::end(order), [&sizes](const std::size_t& a, const std::size_t& b) { return sizes[a] > sizes[b]; });
+
+	std::vector<std::size_t> large;
+	std::vector<std::size_t> small;
+
+	for (const std::size_t& idx : order)
+	{
+		if (poolSize > 1 && sizes[idx] * poolSize > total)
+			large.push_back(idx);
+		else
+			small.push_back(idx);
+	}
+
+	std::vector<std::vector<PatternPair>> results(dbs.size());
+	std::vector<std::unique_ptr<PatternSpectrum>> spectra(dbs.size());
+	std::vector<uint8_t> valid(dbs.size(), 1); // Written concurrently, hence, no std::vector<bool>
+
+	if (pSpectrum)
+	{
+		for (std::unique_ptr<PatternSpectrum>& pS : spectra)
+			pS = std::make_unique<PatternSpectrum>(static_cast<ItemC>(winlen), pSpectrum->WithDuration(), sizeSupports);
+	}
+
+	const auto mine = [&](const std::size_t& idx, const int32_t& growthThreads, const bool pipelined) {
+		std::unique_ptr<PatternExpander> pExpander;
+		FPGrowth fp(dbs[idx], support, zmin, zmax, static_cast<ItemC>(winlen), maxc, minneu, growthThreads, growthTarget, maxDuration, sizeSupports);
+		Transactions().swap(dbs[idx]);
+
+		valid[idx] = runGrowth(fp, growthTarget, closedAlgo, pipelined, results[idx], pExpander, spectra[idx].get());
+	};
+
+	try
+	{
+		for (const std::size_t& idx : large)
+			mine(idx, poolSize, true);
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	// Exceptions must not leave the parallel region
+	std::atomic<bool> aborted(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(poolSize)
+#endif
+	for (int64_t i = 0; i < static_cast<int64_t>(small.size()); i++)
+	{
+		if (aborted) continue;
+
+		try
+		{
+			mine(small[i], 1, false);
+		}
+		catch (const FPGException&)
+		{
+			aborted = true;
+		}
+	}
+
+	if (aborted) EXIT_INTERRUPT();
+
+	LOG_INFO_EVAL << "Converting Pattern to Python Lists ... " << std::flush;
+	Timer t;
+	t.Start();
+
+	try
+	{
+		PyObject* pyList = createPyList(dbs.size());
+
+		for (std::size_t idx = 0; idx < dbs.size(); idx++)
+		{
+			if (valid[idx] && spectra[idx])
+				PyList_SET_ITEM(pyList, idx, createSpectrumList(*spectra[idx]));
+			else if (valid[idx])
+				PyList_SET_ITEM(pyList, idx, createPatternList(results[idx], hashMap));
+			else
+			{
+				Py_INCREF(Py_None);
+				PyList_SET_ITEM(pyList, idx, Py_None);
+			}
+		}
+
+		t.Stop();
+		LOG_INFO_EVAL << "Done after: " << t << std::endl;
+
+		fullTimer.Stop();
+		LOG_INFO_EVAL << " =========  FPGrowth C++ Module End (" << fullTimer << ")  ========= " << std::endl;
+
+		sigRemove();
+		return pyList;
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+	catch (const ModuleException& e)
+	{
+		ERR_MEM(e.what())
+		return nullptr;
+	}
+}
+
+// Approximate fpgrowth (targets 'c' and 'm') on a random sample of round(fraction * n) transactions mined with the
+// support scaled to the sample size, see SampleMining.h. Returns a list of (pattern, support, error) tuples: the support
+// is extrapolated to the whole database and the true support lies within +- error with the given confidence. With
+// verify=True the sample is mined with a lowered support and the supports of the candidates are counted exactly on
+// the whole database (error 0), a closed / maximal set of the database is still missed if it is not closed in the sample.
+PyObject* fpgrowthSample(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	UNUSED(self);
+	const char* ckwds[] = { "tracts", "target", "supp", "zmin", "zmax", "winlen", "max_c", "min_neu", "verbose", "threads", "cdalgo", "max_duration", "fraction", "verify", "confidence", "seed", nullptr };
+	PyObject* tracts;
+	char* target      = nullptr;
+	double supp       = 10;
+	uint32_t zmin     = 1;
+	uint32_t zmax     = 0;
+	uint32_t winlen   = WIN_LEN;
+	uint32_t maxc     = static_cast<uint32_t>(~0);
+	uint32_t minneu   = 1;
+	int32_t verbose   = ToUnderlying(Verbosity::VB_INFO);
+	int32_t threads   = 1;
+	char* cdalgo      = nullptr;
+	int32_t maxdur    = -1;
+	double fraction   = 0.1;
+	int verify        = 0;
+	double confidence = 0.95;
+	uint32_t seed     = 0;
+	ClosedAlgo closedAlgo = ClosedAlgo::CA_TREE;
+	Target growthTarget   = Target::TA_ALL;
+	Timer fullTimer;
+
+	std::map<Py_hash_t, PyObject*> hashMap;
+
+	fullTimer.Start();
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sdIIIIIiisidpdI", const_cast<char**>(ckwds), &tracts, &target, &supp, &zmin, &zmax, &winlen, &maxc, &minneu, &verbose, &threads, &cdalgo, &maxdur, &fraction, &verify, &confidence, &seed))
+		return nullptr;
+
+	if (!parseTarget(target, growthTarget) || !parseClosedAlgo(cdalgo, closedAlgo)) return nullptr;
+
+	if (growthTarget == Target::TA_COMPRESSED)
+	{
+		PyErr_SetString(PyExc_ValueError, "invalid target (must be 'c' or 'm')");
+		return nullptr;
+	}
+
+	if (!(fraction > 0 && fraction <= 1) || !(confidence > 0 && confidence < 1))
+	{
+		PyErr_SetString(PyExc_ValueError, "fraction must be in (0, 1] and confidence in (0, 1)");
+		return nullptr;
+	}
+
+	if (threads < -1) threads = -1;
+
+	const Support support      = static_cast<Support>(std::abs(supp));
+	const uint32_t maxDuration = (maxdur < 0) ? static_cast<uint32_t>(~0) : static_cast<uint32_t>(maxdur);
+
+	SetVerbosity(ToVerbosity(verbose));
+
+	LOG_INFO << " =========  FPGrowth C++ Module (v" VERSION ") - Sample" << "  ========= " << std::endl;
+
+	sigInstall(); // Install signal handler to catch CTRL-C interrupts
+
+	Transactions transactions;
+	std::vector<PatternPair> candidates;
+	std::vector<PatternPair> res;
+
+	try
+	{
+		if (!loadTransactions(tracts, transactions, hashMap)) return nullptr;
+
+		TransactionSample sample(transactions, fraction, seed, confidence);
+		const Support sampleSupport = sample.ScaleSupport(support, verify);
+
+		LOG_INFO << "Sample: " << sample.GetSize() << " / " << transactions.size() << " Transactions - Support: " << sampleSupport << std::endl;
+
+		// Almost every set of the sample is frequent for very low supports
+		if (sampleSupport < 3)
+			LOG_WARNING << "The sample is too small for the support, the result may be very large (increase fraction)" << std::endl;
+
+		// The closed sets of the sample are the candidates for both targets, max_c is applied to the extrapolated supports
+		{
+			std::unique_ptr<PatternExpander> pExpander;
+			FPGrowth fp(sample.GetTransactions(), sampleSupport, zmin, zmax, static_cast<ItemC>(winlen), static_cast<uint32_t>(~0), minneu, threads, Target::TA_ALL, maxDuration);
+			if (!runGrowth(fp, Target::TA_ALL, closedAlgo, true, candidates, pExpander)) Py_RETURN_NONE;
+		}
+
+		if (verify)
+		{
+			Timer t;
+			t.Start();
+
+			VerifyCandidates(candidates, SupportCounter(transactions), support);
+
+			t.Stop();
+			LOG_INFO << "Verified Pattern: " << candidates.size() << " - Done after: " << t << std::endl;
+		}
+		else
+		{
+			for (PatternPair& pp : candidates)
+				pp.second = sample.Extrapolate(pp.second);
+		}
+
+		const Job job = { support, zmin, zmax, minneu, maxc };
+		JobDetection(candidates, job, static_cast<ItemC>(winlen), growthTarget, res);
+		candidates.clear();
+
+		PyObject* pyList = createPatternList(res, hashMap);
+
+		// (pattern, support) -> (pattern, support, error)
+		for (auto [idx, pp] : enumerate(res))
+		{
+			PyObject* pyPair   = PyList_GET_ITEM(pyList, idx);
+			PyObject* pyRecord = createPyTuple(3);
+
+			for (Py_ssize_t i = 0; i < 2; i++)
+			{
+				PyObject* pyVal = PyTuple_GET_ITEM(pyPair, i);
+				Py_INCREF(pyVal);
+				PyTuple_SET_ITEM(pyRecord, i, pyVal);
+			}
+
+			PyTuple_SET_ITEM(pyRecord, 2, long2PyLong(verify ? 0 : static_cast<long>(sample.Error(pp.second))));
+			PyList_SetItem(pyList, idx, pyRecord);
+		}
+
+		fullTimer.Stop();
+		LOG_INFO_EVAL << " =========  FPGrowth C++ Module End (" << fullTimer << ")  ========= " << std::endl;
+
+		sigRemove();
+		return pyList;
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+	catch (const ModuleException& e)
+	{
+		ERR_MEM(e.what())
+		return nullptr;
+	}
+}
+
+// Estimates the output size, runtime and peak memory of fpgrowth with the same arguments before running it: the database
+// is reduced and the tree is built as usual, afterwards, a sample of the top-level items (one per stratum of similar
+// cost, see FPGrowth::Estimate) is mined and the results are extrapolated to all items. The returned dict contains:
+//  - items       : exact frequency of every item of the database
+//  - lengths     : histogram of the transaction lengths {length: count}
+//  - tree_items, tree_nodes: size of the tree
+//  - sampled     : number of mined top-level items
+//  - patterns    : itemsets generated by the growth (before the closed / maximal filter)
+//  - build_time, runtime: seconds for the tree build and the whole run (build and growth)
+//  - tree_bytes, thread_bytes, pattern_bytes, memory: node pools, pattern blocks without pipelining and their sum
+PyObject* estimate(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	UNUSED(self);
+	const char* ckwds[] = { "tracts", "target", "supp", "zmin", "zmax", "winlen", "max_c", "min_neu", "verbose", "threads", "max_duration", "supp_by_size", "sample", "seed", nullptr };
+	PyObject* tracts;
+	char* target    = nullptr;
+	double supp     = 10;
+	uint32_t zmin   = 1;
+	uint32_t zmax   = 0;
+	uint32_t winlen = WIN_LEN;
+	uint32_t maxc   = static_cast<uint32_t>(~0);
+	uint32_t minneu = 1;
+	int32_t verbose = ToUnderlying(Verbosity::VB_INFO);
+	int32_t threads = 1;
+	int32_t maxdur  = -1;
+	PyObject* suppBySize = nullptr;
+	uint32_t sample = 128;
+	uint32_t seed   = 0;
+	Target growthTarget = Target::TA_ALL;
+
+	std::map<Py_hash_t, PyObject*> hashMap;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sdIIIIIiiiOII", const_cast<char**>(ckwds), &tracts, &target, &supp, &zmin, &zmax, &winlen, &maxc, &minneu, &verbose, &threads, &maxdur, &suppBySize, &sample, &seed))
+		return nullptr;
+
+	if (!parseTarget(target, growthTarget)) return nullptr;
+
+	if (threads < -1) threads = -1;
+
+	const Support support      = static_cast<Support>(std::abs(supp));
+	const uint32_t maxDuration = (maxdur < 0) ? static_cast<uint32_t>(~0) : static_cast<uint32_t>(maxdur);
+
+	std::vector<Support> sizeSupports;
+	if (!parseSizeSupports(suppBySize, support, sizeSupports)) return nullptr;
+
+	SetVerbosity(ToVerbosity(verbose));
+
+	LOG_INFO << " =========  FPGrowth C++ Module (v" VERSION ") - Estimation" << "  ========= " << std::endl;
+
+	sigInstall(); // Install signal handler to catch CTRL-C interrupts
+
+	Transactions transactions;
+	FrequencyMap frequency;
+	std::map<std::size_t, std::size_t> lengths;
+	GrowthEstimate est;
+	double buildTime = 0;
+	std::size_t treeItems = 0;
+
+	try
+	{
+		if (!loadTransactions(tracts, transactions, hashMap)) return nullptr;
+
+		// The tree build reduces the transactions in place
+		for (const Transaction& trans : transactions)
+		{
+			lengths[trans.size()]++;
+			for (const ItemC& item : trans)
+				frequency[item]++;
+		}
+
+		FPGrowth fp(transactions, support, zmin, zmax, static_cast<ItemC>(winlen), maxc, minneu, threads, growthTarget, maxDuration, sizeSupports);
+
+		est       = fp.Estimate(sample, seed);
+		buildTime = fp.GetInitTime().GetElapsedTimeInSec();
+		treeItems = fp.GetItemCount();
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	PyObject* pyDict = PyDict_New();
+	if (!pyDict)
+	{
+		ERR_MEM("Unable to allocate memory for the estimation");
+		return nullptr;
+	}
+
+	try
+	{
+		// The entries are owned by the result, the dicts are filled afterwards
+		PyObject* pyItems   = PyDict_New();
+		PyObject* pyLengths = PyDict_New();
+		setDictItem(pyDict, "items", pyItems);
+		setDictItem(pyDict, "lengths", pyLengths);
+
+		// The items of the transactions are the (truncated) hashes of the Python objects
+		std::map<ItemC, PyObject*> item2Obj;
+		for (const auto& [h, pItem] : hashMap)
+			item2Obj.try_emplace(static_cast<ItemC>(h), pItem);
+
+		for (const auto& [item, cnt] : frequency)
+		{
+			PyObject* pyCnt = long2PyLong(static_cast<long>(cnt));
+			PyDict_SetItem(pyItems, item2Obj[item], pyCnt);
+			Py_DECREF(pyCnt);
+		}
+
+		for (const auto& [len, cnt] : lengths)
+		{
+			PyObject* pyLen = long2PyLong(static_cast<long>(len));
+			PyObject* pyCnt = long2PyLong(static_cast<long>(cnt));
+			PyDict_SetItem(pyLengths, pyLen, pyCnt);
+			cleanupPyRefs({ pyLen, pyCnt });
+		}
+
+		const double memory = static_cast<double>(est.treeBytes + est.threadBytes) + est.patternBytes;
+
+		setDictItem(pyDict, "tree_items", long2PyLong(static_cast<long>(treeItems)));
+		setDictItem(pyDict, "tree_nodes", long2PyLong(static_cast<long>(est.treeNodes)));
+		setDictItem(pyDict, "sampled", long2PyLong(static_cast<long>(est.sampled)));
+		setDictItem(pyDict, "patterns", long2PyLong(std::lround(est.patterns)));
+		setDictItem(pyDict, "build_time", PyFloat_FromDouble(buildTime));
+		setDictItem(pyDict, "runtime", PyFloat_FromDouble(buildTime + est.growthTime));
+		setDictItem(pyDict, "tree_bytes", long2PyLong(static_cast<long>(est.treeBytes)));
+		setDictItem(pyDict, "thread_bytes", long2PyLong(static_cast<long>(est.threadBytes)));
+		setDictItem(pyDict, "pattern_bytes", long2PyLong(std::lround(est.patternBytes)));
+		setDictItem(pyDict, "memory", long2PyLong(std::lround(memory)));
+	}
+	catch (const ModuleException& e)
+	{
+		Py_DECREF(pyDict);
+		ERR_MEM(e.what())
+		return nullptr;
+	}
+
+	LOG_INFO << "Estimated Pattern: " << std::lround(est.patterns) << " - Runtime: " << buildTime + est.growthTime << "s - Memory: "
+			 << (static_cast<double>(est.treeBytes + est.threadBytes) + est.patternBytes) / (1024.0 * 1024.0) << " MB" << std::endl;
+
+	sigRemove();
+	return pyDict;
+}
+
+// =========  Persistent Tree  ======== //
+
+// Builds the database and the tree once, the returned FPTree runs growths with stricter parameters (supp, zmin and
+// min_neu at least the ones given here) on it, e.g., tree = fptree(tracts, supp=10); tree.fpgrowth(supp=20, target='m').
+// New transactions can be appended to the tree, a tree that is built with supp=1 keeps (almost) all items and rarely has to be rebuilt.
+PyObject* fptree(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	UNUSED(self);
+	const char* ckwds[] = { "tracts", "supp", "zmin", "winlen", "min_neu", "verbose", "threads", nullptr };
+	PyObject* tracts;
+	double supp     = 10;
+	uint32_t zmin   = 1;
+	uint32_t winlen = WIN_LEN;
+	uint32_t minneu = 1;
+	int32_t verbose = ToUnderlying(Verbosity::VB_INFO);
+	int32_t threads = 1;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|dIIIii", const_cast<char**>(ckwds), &tracts, &supp, &zmin, &winlen, &minneu, &verbose, &threads))
+		return nullptr;
+
+	if (threads < -1) threads = -1;
+
+	SetVerbosity(ToVerbosity(verbose));
+
+	LOG_INFO << " =========  FPGrowth C++ Module (v" VERSION ") - Building Tree" << "  ========= " << std::endl;
+
+	sigInstall(); // Install signal handler to catch CTRL-C interrupts
+
+	std::unique_ptr<std::map<Py_hash_t, PyObject*>> pHashMap = std::make_unique<std::map<Py_hash_t, PyObject*>>();
+	std::unique_ptr<FPGrowth> pFP;
+	Transactions transactions;
+
+	try
+	{
+		if (!loadTransactions(tracts, transactions, *pHashMap)) return nullptr;
+
+		pFP = std::make_unique<FPGrowth>(transactions, static_cast<Support>(std::abs(supp)), zmin, 0, static_cast<ItemC>(winlen), static_cast<uint32_t>(~0), minneu, threads);
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	FPTreeObject* pTree = PyObject_New(FPTreeObject, reinterpret_cast<PyTypeObject*>(pFPTreeType));
+	if (!pTree)
+	{
+		ERR_MEM("Unable to allocate memory for the Python FPTree");
+		return nullptr;
+	}
+
+	// The transactions can be released before the tree, hence, the tree keeps its own references
+	for (const auto& [h, pItem] : *pHashMap)
+		Py_INCREF(pItem);
+
+	pTree->pFP      = pFP.release();
+	pTree->pHashMap = pHashMap.release();
+
+	sigRemove();
+	return reinterpret_cast<PyObject*>(pTree);
+}
+
+PyObject* treeGrowth(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	FPTreeObject* pTree = reinterpret_cast<FPTreeObject*>(self);
+	FPGrowth& fp        = *pTree->pFP;
+	const Job& build    = fp.GetBuildParams();
+
+	const char* ckwds[] = { "target", "supp", "zmin", "zmax", "max_c", "min_neu", "verbose", "threads", "pipelined", "cdalgo", "expand", "max_duration", "supp_by_size", nullptr };
+	char* target    = nullptr;
+	double supp     = build.minSupport;
+	uint32_t zmin   = build.minPatternLen;
+	uint32_t zmax   = 0;
+	uint32_t maxc   = static_cast<uint32_t>(~0);
+	uint32_t minneu = build.minNeuronCount;
+	int32_t verbose = ToUnderlying(Verbosity::VB_INFO);
+	int32_t threads = 1;
+	int pipelined   = 1;
+	char* cdalgo    = nullptr;
+	int expand      = 1;
+	int32_t maxdur  = -1;
+	PyObject* suppBySize = nullptr;
+	ClosedAlgo closedAlgo = ClosedAlgo::CA_TREE;
+	Target growthTarget   = Target::TA_ALL;
+	Timer fullTimer;
+
+	fullTimer.Start();
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sdIIIIiipspiO", const_cast<char**>(ckwds), &target, &supp, &zmin, &zmax, &maxc, &minneu, &verbose, &threads, &pipelined, &cdalgo, &expand, &maxdur, &suppBySize))
+		return nullptr;
+
+	if (!parseTarget(target, growthTarget) || !parseClosedAlgo(cdalgo, closedAlgo)) return nullptr;
+
+	if (threads < -1) threads = -1;
+
+	Job job;
+	job.minSupport     = static_cast<Support>(std::abs(supp));
+	job.minPatternLen  = zmin;
+	job.maxPatternLen  = zmax;
+	job.minNeuronCount = minneu;
+	job.maxSupport     = maxc;
+
+	std::vector<Support> sizeSupports;
+	if (!parseSizeSupports(suppBySize, job.minSupport, sizeSupports)) return nullptr;
+
+	SetVerbosity(ToVerbosity(verbose));
+
+	const uint32_t maxDuration = (maxdur < 0) ? static_cast<uint32_t>(~0) : static_cast<uint32_t>(maxdur);
+
+	if (!fp.SetQuery(job, growthTarget, maxDuration, sizeSupports, threads))
+	{
+		PyErr_SetString(PyExc_ValueError, "supp, zmin and min_neu must not be lower than the ones the tree was built with");
+		return nullptr;
+	}
+
+	sigInstall(); // Install signal handler to catch CTRL-C interrupts
+
+	std::vector<PatternPair> closed;
+	std::unique_ptr<PatternExpander> pExpander;
+
+	try
+	{
+		if (!runGrowth(fp, growthTarget, closedAlgo, pipelined, closed, pExpander)) Py_RETURN_NONE;
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	return createResult(closed, pExpander, expand, *pTree->pHashMap, fullTimer);
+}
+
+// Appends new transactions, e.g., the time bins recorded since the tree was built, the following growths include them.
+// Returns False if an item that was removed from the tree by the support at build time could become frequent,
+// the tree is left unchanged and has to be rebuilt with fptree from the whole database in this case.
+PyObject* treeAppend(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	FPTreeObject* pTree = reinterpret_cast<FPTreeObject*>(self);
+
+	const char* ckwds[] = { "tracts", "rerank", "verbose", nullptr };
+	PyObject* tracts;
+	int rerank      = 0;
+	int32_t verbose = ToUnderlying(Verbosity::VB_INFO);
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|pi", const_cast<char**>(ckwds), &tracts, &rerank, &verbose))
+		return nullptr;
+
+	SetVerbosity(ToVerbosity(verbose));
+
+	sigInstall(); // Install signal handler to catch CTRL-C interrupts
+
+	std::map<Py_hash_t, PyObject*> hashMap;
+	Transactions transactions;
+	bool appended;
+
+	try
+	{
+		if (!loadTransactions(tracts, transactions, hashMap)) return nullptr;
+
+		appended = pTree->pFP->Append(transactions, rerank);
+	}
+	catch (const FPGException&)
+	{
+		EXIT_INTERRUPT();
+	}
+
+	if (appended)
+	{
+		for (const auto& [h, pItem] : hashMap)
+		{
+			if (pTree->pHashMap->try_emplace(h, pItem).second)
+				Py_INCREF(pItem);
+		}
+	}
+
+	sigRemove();
+	return PyBool_FromLong(appended);
+}
+
+void treeDealloc(PyObject* self)
+{
+	FPTreeObject* pTree = reinterpret_cast<FPTreeObject*>(self);
+	PyTypeObject* pType = Py_TYPE(self);
+
+	delete pTree->pFP;
+
+	if (pTree->pHashMap)
+	{
+		for (const auto& [h, pItem] : *pTree->pHashMap)
+			Py_XDECREF(pItem);
+
+		delete pTree->pHashMap;
+	}
+
+	pType->tp_free(self);
+	Py_DECREF(pType);
+}